@@ -0,0 +1,23 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "Global.hpp"
+#include "Pipeline.hpp"
+
+/**
+ * @brief Processes several cases concurrently on one shared work-stealing pool.
+ *
+ * Threads are allotted in proportion to the size of each case's design.net, so
+ * small cases run side by side while large ones get more threads. Every case
+ * goes through runCase(), the same flow as a single run, with its results in
+ * output/<case name>/ (see prepareOutputDir()). A summary table is printed at
+ * the end. Cases whose
+ * directories share a name would overwrite each other's results, so such a
+ * batch is rejected before any case runs.
+ * @param case_dirs The case directories to process.
+ * @param num_threads Pool size; 0 uses the hardware concurrency.
+ * @return 0 if every case succeeded with legal routes, 1 otherwise.
+ */
+int runBatch(const std::vector<std::string>& case_dirs, size_t num_threads = 0);
+
+#endif // BATCH_HPP
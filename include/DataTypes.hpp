@@ -56,4 +56,23 @@ public:
     int weight;                           // Weight of the net (always 1 in this problem).
 };
 
+// Largest TDM ratio allowed on any hop (see benchmarks/README.md).
+constexpr double kMaxTdmRatio = 512.0;
+
+/**
+ * @class NetRoute
+ * @brief Routing result of one net, as stored in a design.route.out file.
+ * * Each path is a list of FPGA IDs from the source FPGA to one sink FPGA.
+ * ratios[i][k] is the TDM ratio used on hop k of paths[i].
+ */
+class NetRoute {
+public:
+    int net_id;                                  // ID of the routed net.
+    std::vector<std::vector<int>> paths;         // One FPGA path per sink FPGA.
+    std::vector<std::vector<double>> ratios;     // TDM ratio of every hop, parallel to paths.
+
+    NetRoute() : net_id(-1) {}
+    NetRoute(int netId) : net_id(netId) {}
+};
+
 #endif // DATATYPES_HPP
\ No newline at end of file
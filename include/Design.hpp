@@ -15,6 +15,20 @@
  */
 class Design {
 public:
+    // Maps a connection pattern string to the IDs of the nets sharing it.
+    using NetGroupMap = std::map<std::string, std::vector<int>>;
+    // Maps a source/sink-FPGA-set key (counts ignored) to the count-level groups it merges.
+    using ConsolidatedGroupMap = std::map<std::string, NetGroupMap>;
+
+    /**
+     * @struct NetDiff
+     * @brief Result of diffNets(): how the nets of a design relate to a previous one.
+     */
+    struct NetDiff {
+        std::vector<int> previous_ids;   // Per net (index ID-1): ID of the same net in the previous design, 0 if new.
+        std::vector<int> changed;        // Sorted IDs of the nets whose previous route cannot be kept.
+    };
+
     Design() = default;
 
     /**
@@ -35,6 +49,14 @@ public:
      */
     void loadTopo(const std::string& filename);
 
+    /**
+     * @brief Parses a .topo or .newtopo file into an adjacency matrix.
+     * @param filename Path to the topology file.
+     * @param num_fpgas Number of FPGAs, i.e. the matrix dimension.
+     * @return The channel count between every pair of FPGAs.
+     */
+    static std::vector<std::vector<int>> parseTopology(const std::string& filename, size_t num_fpgas);
+
     /**
      * @brief Loads the mapping of logical nodes to FPGAs from a .fpga.out file.
      * @param filename Path to the design.fpga.out file.
@@ -47,6 +69,12 @@ public:
      * @param filename The path for the output JSON file.
      */
     void generateVisualizationData(const std::string& filename) const; // Added const
+
+    /**
+     * @brief Counts source-sink node connections between every pair of FPGAs.
+     * @return Symmetric matrix; entry [i][j] counts connections in either direction.
+     */
+    std::vector<std::vector<int>> computeLogicalDemand() const;
     
     /**
      * @brief Groups nets based on their FPGA connection patterns.
@@ -57,6 +85,40 @@ public:
      */
     std::vector<std::vector<int>> groupNetsByFpgaConnection() const;
 
+    /**
+     * @brief Builds the keyed group map that groupNetsByFpgaConnection() flattens.
+     * @return Connection pattern -> sorted net IDs.
+     */
+    NetGroupMap buildNetGroupMap() const;
+
+    /**
+     * @brief Builds both grouping levels in a single pass over the nets.
+     *
+     * The outer key ignores per-FPGA node counts, e.g. "3:1,7", so it merges all
+     * groups of groupNetsByFpgaConnection() that share source and sink FPGAs.
+     * The inner map holds those original count-level groups.
+     * @return Consolidation key -> (connection pattern -> sorted net IDs).
+     */
+    ConsolidatedGroupMap consolidateNetGroups() const;
+
+    /**
+     * @brief Matches the nets against a previous design and lists those needing a new route.
+     *
+     * Nets are matched by content (source and sink node IDs), not by line number, so
+     * inserting or deleting lines in design.net only affects the nets involved.
+     * Routes only depend on the source FPGA and the sink FPGA set, so a matched net
+     * whose FPGAs are unchanged keeps its previous route.
+     * @param previous The design loaded before the netlist/mapping change.
+     * @return The matching and the changed nets.
+     */
+    NetDiff diffNets(const Design& previous) const;
+
+    /**
+     * @brief Builds the connection pattern of a net, e.g. "3:1(2),7(1)".
+     * @return The pattern string, or an empty string if the net has no FPGA.
+     */
+    static std::string connectionPattern(const Net& net);
+
     // Public getters to access the parsed data.
     const std::vector<FPGA>& getFpgas() const { return fpgas_; }
     const std::unordered_map<int, Node>& getNodes() const { return nodes_; }
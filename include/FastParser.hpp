@@ -5,11 +5,17 @@
 
 /**
  * @class FastParser
- * @brief A high-performance file parser using fread.
+ * @brief A high-performance, line-oriented file parser using fread.
  *
  * This class reads an entire file into a memory buffer upon construction
  * and provides methods to parse data types (integers, IDs) directly
  * from this buffer. This approach minimizes I/O overhead.
+ *
+ * Parsing is line by line: nextLine() finds the end of the next non-empty
+ * line with memchr, and tokens are only read up to that line end, so callers
+ * detect the end of a record with atLineEnd() instead of guessing from the
+ * next line's first character. Malformed input throws a std::runtime_error
+ * naming the file and line.
  */
 class FastParser {
 public:
@@ -29,52 +35,90 @@ public:
     FastParser& operator=(const FastParser&) = delete;
 
     /**
-     * @brief Checks if the parser has reached the end of the file buffer.
-     * @return True if all characters have been processed, false otherwise.
+     * @brief Moves to the first token of the next non-empty line.
+     *
+     * Whatever is left of the current line is skipped.
+     * @return False once the end of the file is reached.
      */
-    bool isEOF() const;
-    
+    bool nextLine();
+
     /**
-     * @brief Peeks at the next non-whitespace character without consuming it.
-     * @return The next non-whitespace character, or '\0' if at the end of the file.
+     * @brief Skips blanks and checks whether the current line has no more tokens.
+     * @return True at the end of the line (or file).
      */
-    char peekNextNonWhitespaceChar();
+    bool atLineEnd();
 
     /**
-     * @brief Parses a non-negative integer from the current buffer position.
+     * @brief Fails if anything but blanks is left on the current line.
      *
-     * It automatically skips any leading whitespace.
+     * Called after the last field of a record, so trailing tokens are not silently dropped.
+     */
+    void expectLineEnd();
+
+    /**
+     * @brief Skips blanks and returns the next character on the line without consuming it.
+     * @return The character, or '\0' at the end of the line.
+     */
+    char peekChar();
+
+    /**
+     * @brief Consumes the next character on the line if it equals c.
+     * @return True if the character was consumed.
+     */
+    bool acceptChar(char c);
+
+    /**
+     * @brief Consumes the character c (e.g. ':' or ','); fails if it is not next.
+     */
+    void expectChar(char c);
+
+    /**
+     * @brief Consumes a literal word (e.g. "net"); fails if it is not next.
+     */
+    void expectWord(const char* word);
+
+    /**
+     * @brief Parses a non-negative integer from the current line; fails if it does not fit in an int.
      * @return The parsed integer value.
      */
-    int parseInt();
+    int readInt();
 
     /**
      * @brief Parses an identifier with a specific prefix (e.g., 'F' for FPGAs, 'g' for nodes).
-     * * It skips the prefix character and then parses the following integer.
-     * e.g., for "g123", it will return 123.
+     * * e.g., for "g123", it will return 123.
      * @param prefix The character prefix to expect and skip.
      * @return The integer part of the identifier.
      */
-    int parseId(char prefix);
+    int readId(char prefix);
 
     /**
-     * @brief Skips a specific character at the current position.
+     * @brief Parses a non-negative decimal number (e.g., "41.2") from the current line.
      *
-     * This is useful for parsing delimiters like ':' and ','.
-     * It also skips any surrounding whitespace.
+     * "nan", "inf" and out-of-range exponents are rejected.
+     * @return The parsed value.
      */
-    void skipChar(char c);
+    double readDouble();
 
     /**
-     * @brief Advances the internal pointer until a non-whitespace character is found.
+     * @brief The 1-based number of the current line.
      */
-    void skipWhitespace();
+    size_t lineNumber() const { return line_number_; }
+
+    /**
+     * @brief Throws a std::runtime_error prefixed with "file:line: ".
+     */
+    [[noreturn]] void fail(const std::string& message) const;
 
 private:
+    // Advances past spaces, tabs and '\r' without leaving the current line.
+    void skipBlanks();
+
+    std::string filename_;  // Name of the parsed file, for error messages.
     char* buffer_;          // Pointer to the start of the file content buffer.
     char* current_pos_;     // Pointer to the current parsing position in the buffer.
+    char* line_end_;        // The '\n' (or buffer end) that terminates the current line.
     size_t file_size_;      // Total size of the file in bytes.
+    size_t line_number_;    // 1-based number of the current line; 0 before the first one.
 };
 
 #endif // FAST_PARSER_HPP
-
@@ -0,0 +1,228 @@
+#ifndef FIXED_KERNELS_HPP
+#define FIXED_KERNELS_HPP
+
+#include "Global.hpp"
+#include "DataTypes.hpp"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * Compile-time specialized kernels for systems with at most 64 * Words FPGAs.
+ *
+ * Design and Router pick Words = 1 (N <= 64) or Words = 4 (N <= 256) at runtime
+ * from the FPGA count and fall back to their generic code for larger systems.
+ * Terminal sets are fixed-size bit masks and scratch data lives in std::array,
+ * so the kernels do no per-net allocation. All kernels visit FPGAs in ascending
+ * index order and therefore produce exactly the same results as the generic code.
+ */
+
+// Index of the lowest set bit of a non-zero word.
+inline int lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+/**
+ * @struct FpgaMask
+ * @brief A set of FPGA indices (0-based) stored as a fixed-size bit mask.
+ */
+template <size_t Words>
+struct FpgaMask {
+    static constexpr size_t kCapacity = Words * 64;
+
+    std::array<uint64_t, Words> words{};
+
+    void set(int i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+    bool test(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    bool operator==(const FpgaMask& other) const { return words == other.words; }
+
+    // Calls f(index) for every set bit in ascending order.
+    template <class F>
+    void forEach(F f) const {
+        for (size_t w = 0; w < Words; ++w) {
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+                f(static_cast<int>(w * 64) + lowestBit(bits));
+            }
+        }
+    }
+
+    uint64_t hash() const {
+        uint64_t h = 0;
+        for (uint64_t word : words) {
+            h = (h ^ word) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+};
+
+/**
+ * @struct FpgaConnectionGroup
+ * @brief Nets that share a source FPGA and the same node count on each sink FPGA.
+ */
+struct FpgaConnectionGroup {
+    int src_fpga;                                   // Source FPGA ID.
+    std::vector<std::pair<int, int>> sink_counts;   // (sink FPGA ID, node count), ascending by ID.
+    std::vector<int> net_ids;                       // Member nets in netlist order.
+};
+
+/**
+ * @brief Groups nets by source FPGA and per-sink-FPGA node counts using bit masks.
+ *
+ * Groups are returned in order of first appearance; nets without FPGA are skipped.
+ */
+template <size_t Words>
+std::vector<FpgaConnectionGroup> groupNetsFixed(const std::vector<Net>& nets) {
+    std::vector<FpgaConnectionGroup> groups;
+    std::vector<FpgaMask<Words>> group_masks;
+    std::unordered_map<uint64_t, std::vector<size_t>> buckets;   // Key hash -> group indices.
+    std::array<int, FpgaMask<Words>::kCapacity> counts{};
+
+    for (const auto& net : nets) {
+        if (!net.source || !net.source->fpga) {
+            continue;
+        }
+        int src_idx = net.source->fpga->id - 1;
+
+        FpgaMask<Words> sinks;
+        for (const auto& sink : net.sinks) {
+            if (sink && sink->fpga && sink->fpga->id - 1 != src_idx) {
+                sinks.set(sink->fpga->id - 1);
+                counts[sink->fpga->id - 1]++;
+            }
+        }
+
+        uint64_t key = sinks.hash() ^ (static_cast<uint64_t>(src_idx) * 0x9e3779b97f4a7c15ULL);
+        sinks.forEach([&](int i) { key = (key ^ static_cast<uint64_t>(counts[i])) * 0x100000001b3ULL; });
+
+        // Compare against every group with the same hash; counts are checked in mask order.
+        auto& bucket = buckets[key];
+        size_t found = groups.size();
+        for (size_t g : bucket) {
+            if (groups[g].src_fpga != src_idx + 1 || !(group_masks[g] == sinks)) {
+                continue;
+            }
+            bool same = true;
+            for (const auto& sc : groups[g].sink_counts) {
+                if (counts[sc.first - 1] != sc.second) {
+                    same = false;
+                    break;
+                }
+            }
+            if (same) {
+                found = g;
+                break;
+            }
+        }
+
+        if (found == groups.size()) {
+            FpgaConnectionGroup group;
+            group.src_fpga = src_idx + 1;
+            sinks.forEach([&](int i) { group.sink_counts.push_back({i + 1, counts[i]}); });
+            groups.push_back(std::move(group));
+            group_masks.push_back(sinks);
+            bucket.push_back(found);
+        }
+        groups[found].net_ids.push_back(net.id);
+
+        // Reset only the touched counters.
+        sinks.forEach([&](int i) { counts[i] = 0; });
+    }
+    return groups;
+}
+
+/**
+ * @brief Packs the topology into adjacency masks, Words 64-bit words per row.
+ */
+template <size_t Words>
+std::vector<uint64_t> buildAdjacencyMasks(const std::vector<std::vector<int>>& topo) {
+    std::vector<uint64_t> adj(topo.size() * Words, 0);
+    for (size_t u = 0; u < topo.size(); ++u) {
+        for (size_t v = 0; v < topo[u].size(); ++v) {
+            if (topo[u][v] > 0) {
+                adj[u * Words + (v >> 6)] |= uint64_t(1) << (v & 63);
+            }
+        }
+    }
+    return adj;
+}
+
+/**
+ * @brief Breadth-first search over adjacency masks.
+ *
+ * Fills parents[v] with the BFS parent of v (parents[src] = src, -1 if unreachable).
+ * Neighbors are expanded in ascending index order, matching the generic search.
+ */
+template <size_t Words>
+void bfsParentsFixed(const std::vector<uint64_t>& adj, size_t num_fpgas, int src, std::vector<int>& parents) {
+    std::array<int, FpgaMask<Words>::kCapacity> queue;
+    std::array<uint64_t, Words> unvisited{};
+    for (size_t v = 0; v < num_fpgas; ++v) {
+        unvisited[v >> 6] |= uint64_t(1) << (v & 63);
+    }
+
+    parents.assign(num_fpgas, -1);
+    parents[src] = src;
+    unvisited[src >> 6] &= ~(uint64_t(1) << (src & 63));
+
+    size_t head = 0;
+    size_t tail = 0;
+    queue[tail++] = src;
+    while (head < tail) {
+        int u = queue[head++];
+        const uint64_t* row = &adj[static_cast<size_t>(u) * Words];
+        for (size_t w = 0; w < Words; ++w) {
+            uint64_t fresh = row[w] & unvisited[w];
+            unvisited[w] &= ~fresh;
+            for (; fresh; fresh &= fresh - 1) {
+                int v = static_cast<int>(w * 64) + lowestBit(fresh);
+                parents[v] = u;
+                queue[tail++] = v;
+            }
+        }
+    }
+}
+
+/**
+ * @brief The set of sink FPGA indices of a net, excluding src_idx.
+ */
+template <size_t Words>
+FpgaMask<Words> sinkFpgaMask(const Net& net, int src_idx) {
+    FpgaMask<Words> sinks;
+    for (const auto& sink : net.sinks) {
+        if (sink && sink->fpga && sink->fpga->id - 1 != src_idx) {
+            sinks.set(sink->fpga->id - 1);
+        }
+    }
+    return sinks;
+}
+
+/**
+ * @brief Collects the distinct sink FPGA indices of a net (excluding src_idx), ascending.
+ */
+template <size_t Words>
+void collectSinkFpgasFixed(const Net& net, int src_idx, std::vector<int>& sink_idxs) {
+    sink_idxs.clear();
+    sinkFpgaMask<Words>(net, src_idx).forEach([&](int i) { sink_idxs.push_back(i); });
+}
+
+/**
+ * @brief Checks whether two nets (possibly of different designs) have the same
+ *        source FPGA and sink FPGA set, i.e. can share one route.
+ */
+template <size_t Words>
+bool sameFpgaConnectionFixed(const Net& a, const Net& b) {
+    int src_a = a.source && a.source->fpga ? a.source->fpga->id - 1 : -1;
+    int src_b = b.source && b.source->fpga ? b.source->fpga->id - 1 : -1;
+    return src_a == src_b && sinkFpgaMask<Words>(a, src_a) == sinkFpgaMask<Words>(b, src_b);
+}
+
+#endif // FIXED_KERNELS_HPP
@@ -0,0 +1,63 @@
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+#include "Global.hpp"
+#include "Design.hpp"
+#include "Router.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @struct OptimizerOptions
+ * @brief Tuning knobs of the post-optimizer.
+ */
+struct OptimizerOptions {
+    size_t chains = 4;            // Independent annealing chains; fixed so results do not depend on the thread count.
+    int iterations = 2000;        // Moves per chain.
+    unsigned seed = 1;            // Chain c uses seed + c.
+    double start_temperature = 0.02;   // Relative to the initial cost.
+};
+
+/**
+ * @class PostOptimizer
+ * @brief Simulated-annealing post-optimization of a legal routing.
+ *
+ * Nets with the same source FPGA and sink FPGA set (the consolidated groups of
+ * Design::consolidateNetGroups()) always share a route, so every move reroutes
+ * one sink path of a whole group at once. A move takes a critical group, bans
+ * the hop with the highest ratio on its slowest path, and reroutes that path by
+ * Dijkstra on the ratios the edges would have after the move. The cost is the
+ * max delay plus a small share of the average delay and a penalty for ratios
+ * above kMaxTdmRatio, under uniform per-edge ratios ceil(load / channels).
+ * Moves are evaluated incrementally: only the edges the group leaves or joins are
+ * re-rated, and only the groups on edges whose ratio changed are re-timed.
+ *
+ * Each chain starts from the router's routes; the chain with the lowest max delay
+ * wins. Finally, TDM ratios are rebalanced per edge: groups with slack get larger
+ * ratios so the critical ones get smaller ratios, while each edge stays within
+ * its channel budget (sum of 1/ratio <= channels).
+ */
+class PostOptimizer {
+public:
+    /**
+     * @brief Constructs an optimizer for a loaded design.
+     * @param design The design; must outlive the optimizer.
+     */
+    explicit PostOptimizer(const Design& design);
+
+    /**
+     * @brief Optimizes the router's routes in place.
+     * @param router A router holding a complete routing of the design.
+     * @param net_groups The design's net groups, as passed to Router::routeAll().
+     * @param options Chain count, iterations and seed.
+     * @param pool Optional pool to run the chains in parallel.
+     * @param max_tasks Upper bound on the threads used from the pool.
+     * @return The max delay after optimization.
+     */
+    double optimize(Router& router, const Design::ConsolidatedGroupMap& net_groups,
+                    const OptimizerOptions& options, ThreadPool* pool = nullptr, size_t max_tasks = 1);
+
+private:
+    const Design& design_;
+};
+
+#endif // OPTIMIZER_HPP
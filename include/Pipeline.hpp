@@ -0,0 +1,59 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include "Global.hpp"
+#include "Design.hpp"
+#include "ThreadPool.hpp"
+#include "Validator.hpp"
+
+/**
+ * @struct CaseResult
+ * @brief Outcome of running one case through runCase(), used for the batch summary table.
+ */
+struct CaseResult {
+    std::string case_dir;      // Case directory as given on the command line.
+    std::string output_dir;    // Where the case's results are written (see prepareOutputDir()).
+    size_t threads = 0;        // Threads allotted to the case.
+    size_t nets = 0;           // Number of nets.
+    size_t groups = 0;         // Number of net groups.
+    long long load_ms = 0;     // File loading time.
+    long long route_ms = 0;    // Routing time.
+    long long optimize_ms = 0; // Post-optimization time.
+    double max_delay = 0.0;    // Max delay of the routed result, as measured by the validator.
+    std::string error;         // Empty on success.
+};
+
+/**
+ * @brief Loads the four design files in the correct logical order.
+ * @param verbose Print each file name before loading it.
+ */
+void loadDesign(Design& design, const std::string& info_file, const std::string& fpga_map_file,
+                const std::string& net_file, const std::string& topo_file, bool verbose = true);
+
+/**
+ * @brief Checks a route file in-process against design.topo, or against new_topo_file if one is given.
+ * @param pool Optional pool for the validator.
+ * @param max_tasks Upper bound on the threads used from the pool.
+ * @param new_topo_file A design.newtopo file, or empty to use the design's topology.
+ * @param verbose Print the report and the validation time.
+ * @return The validation report.
+ */
+ValidationReport validateRoutes(const Design& design, const std::string& route_file, ThreadPool* pool,
+                                size_t max_tasks, const std::string& new_topo_file = "", bool verbose = true);
+
+/**
+ * @brief Runs one case through the whole flow, shared by the single run and batch mode.
+ *
+ * Loads the design, groups the nets once, routes, post-optimizes, and writes
+ * design.route.out, net_groups.txt, net_groups_consolidated.txt,
+ * visualization_data.json and visualization_data.fviz into result.output_dir.
+ * Finally the route file is validated against design.topo.
+ * @param result Reads case_dir, output_dir and threads; fills in the statistics, and
+ *        sets error if the routes are illegal.
+ * @param pool Pool shared by all stages; the case uses at most result.threads of it.
+ * @param verbose Print load progress, stage times and the validation report.
+ * @throws std::exception on unreadable or malformed input.
+ */
+void runCase(CaseResult& result, ThreadPool& pool, bool verbose);
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,39 @@
+#ifndef ROUTE_FILE_HPP
+#define ROUTE_FILE_HPP
+
+#include "Global.hpp"
+
+/**
+ * @struct RouteFile
+ * @brief All routes of a design.route.out file in flat arrays, filled in one pass
+ * without per-net allocation.
+ *
+ * Entry e is the e-th "[net N]" header; its paths are [net_begin[e], net_begin[e + 1]),
+ * and path p covers fpgas[path_begin[p], path_begin[p + 1]) and
+ * ratios[ratio_begin[p], ratio_begin[p + 1]).
+ */
+struct RouteFile {
+    std::vector<int> net_ids;          // Net ID of each [net] entry.
+    std::vector<size_t> net_begin;     // First path of each entry; one extra sentinel at the end.
+    std::vector<size_t> path_begin;    // First hop FPGA of each path; one extra sentinel at the end.
+    std::vector<size_t> ratio_begin;   // First ratio of each path; one extra sentinel at the end.
+    std::vector<int> fpgas;            // FPGA IDs of all paths, concatenated.
+    std::vector<double> ratios;        // Hop ratios of all paths, concatenated.
+
+    size_t numEntries() const { return net_ids.size(); }
+};
+
+/**
+ * @brief Reads a design.route.out file, shared by Router::loadRoutes() and the Validator.
+ *
+ * Only the grammar is checked: every line is a "[net N]" header or a
+ * "[f1,f2,...] [r1,...]" path of the last header with nothing after it, and no
+ * net ID in [1, num_nets] has two headers. Whether the routes fit a design is
+ * left to the caller; IDs outside [1, num_nets] are kept as they are.
+ * @param filename Path to the route file.
+ * @param num_nets Number of nets of the design the routes belong to.
+ * @return The routes in file order.
+ */
+RouteFile readRouteFile(const std::string& filename, size_t num_nets);
+
+#endif // ROUTE_FILE_HPP
@@ -0,0 +1,125 @@
+#ifndef ROUTER_HPP
+#define ROUTER_HPP
+
+#include "Global.hpp"
+#include "Design.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @class Router
+ * @brief Routes nets over the FPGA topology and assigns TDM ratios.
+ *
+ * Every net is routed along shortest-hop paths from its source FPGA to each
+ * sink FPGA. Nets with the same source FPGA and sink FPGA set share one route,
+ * so each consolidated net group is only routed once. After routing, every directed physical edge
+ * (u, v) carrying L nets over C channels gets the ratio ceil(L / C), which
+ * keeps the sum of 1/ratio on the edge within C. The delay of a net is the
+ * largest sum of hop ratios over its paths.
+ */
+class Router {
+public:
+    /**
+     * @brief Constructs a Router for a fully loaded design.
+     * @param design The design to route; must outlive the router.
+     */
+    explicit Router(const Design& design);
+
+    /**
+     * @brief Lets routeAll() spread net groups over a shared thread pool.
+     * @param pool The pool to use, or nullptr to route sequentially.
+     * @param max_tasks Upper bound on the threads this router may occupy.
+     */
+    void setThreadPool(ThreadPool* pool, size_t max_tasks);
+
+    /**
+     * @brief Discards any existing routes and routes every net of the design.
+     * @param groups The design's net groups (Design::consolidateNetGroups()); each
+     *        consolidated group is routed once and its route shared by all members.
+     */
+    void routeAll(const Design::ConsolidatedGroupMap& groups);
+
+    /**
+     * @brief Updates routes loaded for a previous design to the current one.
+     *
+     * Routes of unchanged nets are kept under their new IDs and routes of removed or
+     * changed nets are ripped up. Changed nets with the same source FPGA and sink
+     * FPGA set share one route: the route of an unchanged net with those FPGAs if
+     * there is one, otherwise a new route computed once for the whole group.
+     * Throws a std::runtime_error if a kept route does not start at its net's source
+     * FPGA and end on its sink FPGAs, i.e. the loaded routes belong to another design.
+     * @param diff Result of Design::diffNets() against the design of the loaded routes.
+     * @return The number of newly computed routes.
+     */
+    size_t reroute(const Design::NetDiff& diff);
+
+    /**
+     * @brief Loads existing routes from a design.route.out file (see readRouteFile()).
+     *
+     * Net IDs must lie in [1, num_nets], FPGA IDs in [1, N], and every path needs
+     * at least 2 FPGAs and one ratio per hop; otherwise a std::runtime_error names
+     * the net. Grammar errors name the offending line.
+     * @param filename Path to the route file.
+     * @param num_nets Number of nets of the design the routes were made for.
+     */
+    void loadRoutes(const std::string& filename, size_t num_nets);
+
+    /**
+     * @brief Replaces all routes, keeping their paths and ratios as given.
+     *
+     * Used to install the result of a post-optimization pass.
+     * @param routes Net ID -> route, only for nets that cross FPGAs.
+     */
+    void setRoutes(std::map<int, NetRoute> routes);
+
+    /**
+     * @brief Writes the current routes in design.route.out format.
+     * @param filename Path to the output file.
+     */
+    void writeRoutes(const std::string& filename) const;
+
+    /**
+     * @brief Computes the maximum net delay of the current routes.
+     */
+    double maxDelay() const;
+
+    const std::map<int, NetRoute>& getRoutes() const { return routes_; }
+
+    // Number of nets on every directed edge, indexed by [from FPGA index][to FPGA index].
+    const std::vector<std::vector<int>>& getLoad() const { return load_; }
+
+private:
+    // Returns the BFS parent of every FPGA index when searching from src_idx (cached).
+    const std::vector<int>& parentsFrom(int src_idx);
+
+    // Collects the distinct sink FPGA indices of a net other than src_idx, ascending.
+    void collectSinkFpgas(const Net& net, int src_idx, std::vector<int>& sink_idxs) const;
+
+    // Routes a single net; returns a route without paths if all sinks are local.
+    NetRoute routeNet(const Net& net);
+
+    // Fills the BFS cache for every source FPGA index in src_idxs (in parallel if a pool is set).
+    void precomputeParents(const std::vector<int>& src_idxs);
+
+    // Adds delta to the load of every directed edge the route uses (once per net)
+    // and flags those edges in dirty_.
+    void updateLoad(const NetRoute& route, int delta);
+
+    // Recomputes the TDM ratio of every hop on a dirty edge, then clears the flags.
+    void assignRatios();
+
+    // Rebuilds load_ from routes_ without touching any ratio.
+    void rebuildLoad();
+
+    const Design& design_;
+    ThreadPool* pool_;                                // Optional; not owned.
+    size_t max_tasks_;
+    std::map<int, NetRoute> routes_;                  // Net ID -> route; only nets crossing FPGAs.
+    std::vector<std::vector<int>> bfs_parents_;       // Per source FPGA index; empty until computed.
+    size_t mask_words_;                               // 1 or 4 for the bit-mask kernels, 0 for generic.
+    std::vector<uint64_t> adj_masks_;                 // Topology rows packed for the bit-mask kernels.
+    std::vector<std::vector<int>> load_;              // Nets using each directed edge.
+    std::vector<std::vector<char>> dirty_;            // Edges whose load changed since the last assignRatios().
+    std::vector<std::pair<int, int>> scratch_edges_;  // Reused by updateLoad().
+};
+
+#endif // ROUTER_HPP
@@ -0,0 +1,80 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "Global.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class ThreadPool
+ * @brief A work-stealing thread pool shared by all parallel stages.
+ *
+ * Each worker owns a task deque. Tasks submitted from a worker go to its own
+ * deque and are popped LIFO; idle workers steal FIFO from the other deques.
+ * Threads that wait inside parallelFor() keep executing pending tasks, so
+ * parallel loops can be nested (e.g. one batch case per task, each routing
+ * its net groups in parallel) without deadlocking the pool.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts num_threads - 1 worker threads; the caller of parallelFor() is the last one.
+     * @param num_threads Threads working on a parallel loop, caller included; 0 uses the
+     *        hardware concurrency.
+     */
+    explicit ThreadPool(size_t num_threads = 0);
+
+    /**
+     * @brief Finishes all queued tasks and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Number of threads that can work on a parallel loop (workers + caller).
+     */
+    size_t concurrency() const { return threads_.size() + 1; }
+
+    /**
+     * @brief Queues a task for asynchronous execution.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Runs fn(i) for every i in [0, count) and returns when all calls are done.
+     *
+     * Indices are handed out dynamically to at most max_tasks threads, the caller
+     * included. The first exception thrown by fn is rethrown to the caller.
+     * @param count Number of iterations.
+     * @param max_tasks Upper bound on the threads used for this loop.
+     * @param fn The loop body.
+     */
+    void parallelFor(size_t count, size_t max_tasks, const std::function<void(size_t)>& fn);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // Pops a task from the own queue or steals one; returns false if none was found.
+    bool runPendingTask();
+
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;   // One deque per worker.
+    std::vector<std::thread> threads_;
+    std::mutex wake_mutex_;                              // Guards sleeping on wake_cv_.
+    std::condition_variable wake_cv_;
+    std::atomic<size_t> pending_;                        // Tasks queued but not yet started.
+    std::atomic<size_t> next_queue_;                     // Round-robin target for external submits.
+    std::atomic<bool> stop_;
+};
+
+#endif // THREAD_POOL_HPP
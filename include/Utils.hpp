@@ -3,6 +3,7 @@
 
 
 #include "Design.hpp"
+#include "Validator.hpp"
 
 // Function to print some stats to verify the parser worked correctly.
 void printDesignStats(const Design& design);
@@ -10,8 +11,33 @@ void printDesignStats(const Design& design);
 /**
  * @brief 将net group信息输出到文件
  * @param design 包含设计数据的Design对象
+ * @param groups Design::consolidateNetGroups() 的结果，其内层即原始分组
  * @param output_file 输出文件路径
  */
-void outputNetGroupsToFile(const Design& design, const std::string& output_file);
+void outputNetGroupsToFile(const Design& design, const Design::ConsolidatedGroupMap& groups,
+                           const std::string& output_file);
+
+/**
+ * @brief 将合并后的net group信息输出到文件（忽略每个FPGA上的节点数量）
+ * @param consolidated Design::consolidateNetGroups() 的结果
+ * @param output_file 输出文件路径
+ */
+void outputConsolidatedNetGroupsToFile(const Design::ConsolidatedGroupMap& consolidated,
+                                       const std::string& output_file);
+
+/**
+ * @brief 创建并返回一个算例的输出目录 output/<算例名>/
+ *
+ * 路由结果等输出不写回输入目录，避免覆盖其中的参考文件（如 benchmarks/sample/design.route.out）。
+ * @param case_dir 输入算例目录
+ * @return 以 '/' 结尾的输出目录路径
+ */
+std::string prepareOutputDir(const std::string& case_dir);
+
+/**
+ * @brief 打印验证结果（是否合法、max delay以及前若干条错误信息）
+ * @param report Validator::validate() 的返回结果
+ */
+void printValidationReport(const ValidationReport& report);
 
 #endif // UTLS_HPP
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef VALIDATOR_HPP
+#define VALIDATOR_HPP
+
+#include "Global.hpp"
+#include "Design.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @struct ValidationReport
+ * @brief Result of checking a design.route.out against a loaded Design.
+ */
+struct ValidationReport {
+    bool legal = true;                 // True if no violation was found.
+    double max_delay = 0.0;            // Largest net delay (sum of hop ratios on a path).
+    size_t routed_nets = 0;            // Number of [net] entries in the route file.
+    size_t violations = 0;             // Total number of violations, including unreported ones.
+    std::vector<std::string> errors;   // The first kMaxReportedErrors violation messages.
+};
+
+/**
+ * @class Validator
+ * @brief In-process replacement for the external checker.
+ *
+ * The route file is streamed once into flat arrays, then the nets are checked
+ * in parallel chunks:
+ *   - every path starts at the net's source FPGA and ends at one of its sink FPGAs,
+ *   - every hop uses a physical link, and every sink FPGA is reached,
+ *   - every ratio lies in [1, kMaxTdmRatio] and is the same on all paths of a net
+ *     that share an edge,
+ *   - on each directed edge, the sum of 1/ratio over its nets fits the channel count.
+ * The topology (or the design.newtopo given to loadNewTopo()) must also respect
+ * each FPGA's max_io.
+ */
+class Validator {
+public:
+    static constexpr size_t kMaxReportedErrors = 20;
+
+    /**
+     * @brief Constructs a validator for a fully loaded design.
+     * @param design The design to check against; must outlive the validator.
+     */
+    explicit Validator(const Design& design);
+
+    /**
+     * @brief Spreads the per-net checks over a shared thread pool.
+     * @param pool The pool to use, or nullptr to check sequentially.
+     * @param max_tasks Upper bound on the threads this validator may occupy.
+     */
+    void setThreadPool(ThreadPool* pool, size_t max_tasks);
+
+    /**
+     * @brief Checks routes against a re-networked topology instead of design.topo.
+     * @param filename Path to the design.newtopo file.
+     */
+    void loadNewTopo(const std::string& filename);
+
+    /**
+     * @brief Validates a route file and computes its max delay.
+     *
+     * Malformed files (trailing tokens, a repeated [net N] header) throw a parser
+     * error instead of producing a report.
+     * @param route_file Path to the design.route.out file.
+     * @return The validation report.
+     */
+    ValidationReport validate(const std::string& route_file) const;
+
+private:
+    const Design& design_;
+    std::vector<std::vector<int>> topology_;    // Topology the routes are checked against.
+    ThreadPool* pool_;                          // Optional; not owned.
+    size_t max_tasks_;
+};
+
+#endif // VALIDATOR_HPP
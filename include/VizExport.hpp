@@ -0,0 +1,59 @@
+#ifndef VIZ_EXPORT_HPP
+#define VIZ_EXPORT_HPP
+
+#include "Global.hpp"
+#include "Design.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Compact binary visualization export (.fviz), read by scripts/visualization.html.
+ *
+ * All values are little-endian (byte-swapped when written on a big-endian host).
+ * Per-item data is stored column by column, so the viewer can wrap each array in a
+ * typed array without parsing:
+ *
+ *   char[8]  magic "FPGAVIZ1"
+ *   uint32   num_fpgas
+ *   uint32   num_levels
+ *   then for each level (level 0 has one cluster per FPGA, each further level merges
+ *   the clusters of the previous one on a coarser layout grid):
+ *     uint32   num_clusters, num_edges
+ *     uint32   cluster_of_fpga[num_fpgas]
+ *     float32  x[num_clusters], y[num_clusters]        layout position in [0, 1]
+ *     int32    fpga_count[], node_count[], max_io[], used_io[]   per cluster
+ *     uint32   edge_a[num_edges], edge_b[num_edges]    cluster indices, a < b
+ *     int32    capacity[], demand[], load_ab[], load_ba[]        per edge
+ *
+ * capacity is the physical channel count, and load_ab / load_ba count routed nets
+ * in each direction. demand is the number of source-sink node connections between
+ * the two clusters in either direction (Design::computeLogicalDemand()[i][j] summed
+ * over the FPGA pairs), the same value as "demand" in visualization_data.json.
+ * used_io is the number of physical channels attached to the FPGAs of a cluster.
+ * Edges inside a cluster are dropped at the coarser levels.
+ */
+
+/**
+ * @brief Computes a force-directed (Fruchterman-Reingold) layout of the FPGA topology.
+ *
+ * Links attract in proportion to their channel count; all FPGAs repel each other.
+ * The result is deterministic and normalized to [0, 1] in both axes.
+ * @param topology Channel count between every pair of FPGAs.
+ * @param pool Optional pool used to compute the per-FPGA forces in parallel.
+ * @param max_tasks Upper bound on the threads used from the pool.
+ * @return (x, y) of every FPGA index.
+ */
+std::vector<std::pair<float, float>> computeForceLayout(const std::vector<std::vector<int>>& topology,
+                                                        ThreadPool* pool = nullptr, size_t max_tasks = 1);
+
+/**
+ * @brief Writes the .fviz file for a loaded (and optionally routed) design.
+ * @param design The loaded design.
+ * @param routed_load Nets per directed edge (e.g. Router::getLoad()), or nullptr if not routed.
+ * @param filename Path of the output file.
+ * @param pool Optional pool for the layout computation.
+ * @param max_tasks Upper bound on the threads used from the pool.
+ */
+void exportVisualizationBinary(const Design& design, const std::vector<std::vector<int>>* routed_load,
+                               const std::string& filename, ThreadPool* pool = nullptr, size_t max_tasks = 1);
+
+#endif // VIZ_EXPORT_HPP
@@ -0,0 +1,87 @@
+#include "Batch.hpp"
+#include "ThreadPool.hpp"
+#include "Utils.hpp"
+
+static void printSummary(const std::vector<CaseResult>& results, long long total_ms) {
+    std::cout << "\n--- Batch Summary ---" << std::endl;
+    std::cout << std::left << std::setw(28) << "Case" << std::right
+              << std::setw(8) << "Threads" << std::setw(10) << "Nets" << std::setw(9) << "Groups"
+              << std::setw(10) << "Load(ms)" << std::setw(11) << "Route(ms)" << std::setw(9) << "Opt(ms)"
+              << std::setw(12) << "MaxDelay" << "  Status" << std::endl;
+
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(28) << r.case_dir << std::right << std::setw(8) << r.threads;
+        if (r.nets > 0) {
+            std::cout << std::setw(10) << r.nets << std::setw(9) << r.groups << std::setw(10) << r.load_ms
+                      << std::setw(11) << r.route_ms << std::setw(9) << r.optimize_ms << std::setw(12) << r.max_delay;
+        } else {
+            std::cout << std::setw(61) << "";
+        }
+        std::cout << (r.error.empty() ? "  OK" : "  FAILED: " + r.error) << std::endl;
+    }
+    std::cout << "Total wall time: " << total_ms << " milliseconds" << std::endl;
+    std::cout << "---------------------" << std::endl;
+}
+
+int runBatch(const std::vector<std::string>& case_dirs, size_t num_threads) {
+    auto batch_start = std::chrono::high_resolution_clock::now();
+
+    // Outputs are keyed by the case directory name, so two cases must not share one.
+    std::vector<CaseResult> results(case_dirs.size());
+    std::map<std::string, std::string> case_of_output;
+    for (size_t i = 0; i < case_dirs.size(); ++i) {
+        results[i].output_dir = prepareOutputDir(case_dirs[i]);
+        auto inserted = case_of_output.emplace(results[i].output_dir, case_dirs[i]);
+        if (!inserted.second) {
+            std::cerr << "Batch Error: " << inserted.first->second << " and " << case_dirs[i]
+                      << " would both write to " << results[i].output_dir << std::endl;
+            return 1;
+        }
+    }
+
+    ThreadPool pool(num_threads);
+
+    // The netlist size is a cheap estimate of how much work a case needs.
+    std::vector<uintmax_t> weights(case_dirs.size(), 0);
+    uintmax_t total_weight = 0;
+    for (size_t i = 0; i < case_dirs.size(); ++i) {
+        results[i].case_dir = case_dirs[i];
+        std::error_code ec;
+        uintmax_t size = std::filesystem::file_size(case_dirs[i] + "/design.net", ec);
+        weights[i] = ec ? 0 : size;
+        total_weight += weights[i];
+    }
+
+    size_t concurrency = pool.concurrency();
+    for (size_t i = 0; i < case_dirs.size(); ++i) {
+        size_t share = total_weight ? static_cast<size_t>(concurrency * weights[i] / total_weight) : 1;
+        results[i].threads = std::max<size_t>(share, 1);
+    }
+
+    // Start the largest cases first so the small ones fill in around them.
+    std::vector<size_t> order(case_dirs.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return weights[a] > weights[b]; });
+
+    // Errors are recorded per case instead of stopping the batch.
+    pool.parallelFor(order.size(), order.size(), [&](size_t k) {
+        CaseResult& result = results[order[k]];
+        try {
+            runCase(result, pool, false);
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+    });
+
+    auto batch_end = std::chrono::high_resolution_clock::now();
+    printSummary(results, std::chrono::duration_cast<std::chrono::milliseconds>(batch_end - batch_start).count());
+
+    for (const auto& r : results) {
+        if (!r.error.empty()) {
+            return 1;
+        }
+    }
+    return 0;
+}
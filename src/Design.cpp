@@ -1,5 +1,6 @@
 #include "Design.hpp"
 #include "FastParser.hpp"
+#include "FixedKernels.hpp"
 #include <stdexcept>
 #include <vector>
 #include <utility>
@@ -19,12 +20,11 @@ void Design::loadInfo(const std::string& filename) {
     int max_fpga_id = 0;
     std::vector<std::pair<int, int>> fpgas_data;
 
-    while (!parser.isEOF()) {
-        parser.skipWhitespace();
-        if (parser.isEOF()) break;
-        
-        int fpga_id = parser.parseId('F');
-        int max_io = parser.parseInt();
+    // Each line: "F<id> <max_io>".
+    while (parser.nextLine()) {
+        int fpga_id = parser.readId('F');
+        int max_io = parser.readInt();
+        parser.expectLineEnd();
         
         if (fpga_id > 0) {
             fpgas_data.push_back({fpga_id, max_io});
@@ -49,33 +49,24 @@ void Design::loadFpgaMapping(const std::string& filename) {
     }
 
     FastParser parser(filename);
-    while (!parser.isEOF()) {
-        parser.skipWhitespace();
-        if (parser.isEOF()) break;
-        
-        int fpga_id = parser.parseId('F');
-        parser.skipChar(':');
 
-        if(fpga_id <= 0 || fpga_id > fpgas_.size()){
+    // Each line: "F<id>: g<node> g<node> ...".
+    while (parser.nextLine()) {
+        int fpga_id = parser.readId('F');
+        parser.expectChar(':');
+
+        if(fpga_id <= 0 || (size_t)fpga_id > fpgas_.size()){
             continue; // Skip line if FPGA ID is invalid.
         }
         FPGA* current_fpga = &fpgas_[fpga_id - 1];
 
-        // This loop parses all logical nodes belonging to the current FPGA.
-        // It breaks when it peeks a character that indicates a new line ('F') or EOF.
-        while (!parser.isEOF()) {
-            char next_char = parser.peekNextNonWhitespaceChar();
-            if (next_char == 'F' || next_char == '\0') {
-                break; // Found the start of the next FPGA line or end of file.
-            }
+        // All remaining tokens on the line are the logical nodes of this FPGA.
+        while (!parser.atLineEnd()) {
+            int node_id = parser.readId('g');
 
-            int node_id = parser.parseId('g');
-            
-            if (nodes_.find(node_id) == nodes_.end()) {
-                nodes_[node_id] = Node(node_id);
-            }
-            nodes_[node_id].fpga = current_fpga;
-            current_fpga->nodes.push_back(&nodes_[node_id]);
+            Node& node = nodes_.try_emplace(node_id, node_id).first->second;
+            node.fpga = current_fpga;
+            current_fpga->nodes.push_back(&node);
         }
     }
 }
@@ -88,35 +79,27 @@ void Design::loadNets(const std::string& filename) {
     FastParser parser(filename);
     int net_id_counter = 1;
 
-    while (!parser.isEOF()) {
-        parser.skipWhitespace();
-        if (parser.isEOF()) break;
-        
+    auto find_node = [&](int node_id) {
+        auto it = nodes_.find(node_id);
+        if (it == nodes_.end()) {
+            parser.fail("node g" + std::to_string(node_id) + " is not mapped to any FPGA");
+        }
+        return &it->second;
+    };
+
+    // Each line: "g<source> <weight> g<sink> g<sink> ...".
+    while (parser.nextLine()) {
         Net current_net;
         current_net.id = net_id_counter++;
 
-        int source_node_id = parser.parseId('g');
-        current_net.source = &nodes_.at(source_node_id);
-
-        current_net.weight = parser.parseInt();
-
-        // This loop parses all sink nodes for the current net.
-        // It assumes all remaining items on the line are sinks until a new line or EOF.
-        while (!parser.isEOF()) {
-            char next_char = parser.peekNextNonWhitespaceChar();
-            // In the .net file, the next line will also start with 'g'.
-            // A simple way to distinguish is to assume sinks are continuous on one line.
-            // When skipWhitespace() hits a newline, we can infer the sinks have ended.
-            // This is a heuristic. A more robust parser might handle newlines explicitly.
-            // For now, if the next char is not 'g', we assume the sinks list has ended.
-            if (next_char != 'g') {
-                break;
-            }
-            
-            int sink_node_id = parser.parseId('g');
-            current_net.sinks.push_back(&nodes_.at(sink_node_id));
+        current_net.source = find_node(parser.readId('g'));
+        current_net.weight = parser.readInt();
+
+        // All remaining tokens on the line are sinks.
+        while (!parser.atLineEnd()) {
+            current_net.sinks.push_back(find_node(parser.readId('g')));
         }
-        nets_.push_back(current_net);
+        nets_.push_back(std::move(current_net));
     }
 }
 
@@ -124,37 +107,32 @@ void Design::loadTopo(const std::string& filename) {
     if (fpgas_.empty()) {
         throw std::logic_error("Design Error: Please load .info file before .topo file.");
     }
+    topology_ = parseTopology(filename, fpgas_.size());
+}
 
+std::vector<std::vector<int>> Design::parseTopology(const std::string& filename, size_t num_fpgas) {
     FastParser parser(filename);
-    size_t num_fpgas = fpgas_.size();
-    topology_.resize(num_fpgas, std::vector<int>(num_fpgas));
-
-    while (!parser.isEOF()) {
-        parser.skipWhitespace();
-        if (parser.isEOF()) break;
+    std::vector<std::vector<int>> topology(num_fpgas, std::vector<int>(num_fpgas));
 
-        int fpga_id = parser.parseId('F');
-        parser.skipChar(':');
+    // Each line: "F<id>: c1, c2, ..., cN".
+    while (parser.nextLine()) {
+        int fpga_id = parser.readId('F');
+        parser.expectChar(':');
 
         if(fpga_id > 0 && (size_t)fpga_id <= num_fpgas){
             for (size_t i = 0; i < num_fpgas; ++i) {
-                topology_[fpga_id - 1][i] = parser.parseInt();
+                topology[fpga_id - 1][i] = parser.readInt();
                 if (i < num_fpgas - 1) {
-                    parser.skipChar(',');
+                    parser.expectChar(',');
                 }
             }
+            parser.expectLineEnd();
         }
     }
+    return topology;
 }
 
-/**
- * @brief Generate visualization data.
- */
-void Design::generateVisualizationData(const std::string& filename) const {
-    if (fpgas_.empty() || nets_.empty() || topology_.empty()) {
-        throw std::logic_error("Visualization Error: Not all data has been loaded.");
-    }
-
+std::vector<std::vector<int>> Design::computeLogicalDemand() const {
     size_t num_fpgas = fpgas_.size();
     std::vector<std::vector<int>> logical_demand(num_fpgas, std::vector<int>(num_fpgas, 0));
 
@@ -174,7 +152,20 @@ void Design::generateVisualizationData(const std::string& filename) const {
             }
         }
     }
-    
+    return logical_demand;
+}
+
+/**
+ * @brief Generate visualization data.
+ */
+void Design::generateVisualizationData(const std::string& filename) const {
+    if (fpgas_.empty() || nets_.empty() || topology_.empty()) {
+        throw std::logic_error("Visualization Error: Not all data has been loaded.");
+    }
+
+    size_t num_fpgas = fpgas_.size();
+    std::vector<std::vector<int>> logical_demand = computeLogicalDemand();
+
     std::ofstream json_file(filename);
     if (!json_file.is_open()) {
         throw std::runtime_error("Visualization Error: Cannot open file for writing: " + filename);
@@ -219,8 +210,8 @@ void Design::generateVisualizationData(const std::string& filename) const {
                  if (!first_link) {
                     json_file << ",\n";
                 }
-                // We divided by 2 because we double-counted during calculation.
-                json_file << "    {\"source\": " << (i + 1) << ", \"target\": " << (j + 1) << ", \"demand\": " << logical_demand[i][j] / 2 << "}";
+                // Each connection is counted once in [i][j] and once in [j][i], so the upper triangle is the total.
+                json_file << "    {\"source\": " << (i + 1) << ", \"target\": " << (j + 1) << ", \"demand\": " << logical_demand[i][j] << "}";
                 first_link = false;
             }
         }
@@ -231,6 +222,47 @@ void Design::generateVisualizationData(const std::string& filename) const {
     json_file.close();
 }
 
+/**
+ * @brief Builds the connection pattern of a net.
+ */
+std::string Design::connectionPattern(const Net& net) {
+    // 跳过无效的net（没有source或fpga信息）
+    if (!net.source || !net.source->fpga) {
+        return std::string();
+    }
+
+    // 获取源FPGA ID
+    int srcFpgaId = net.source->fpga->id;
+
+    // 收集所有sink所在的FPGA ID，并统计每个FPGA上的节点数量
+    std::map<int, int> sinkFpgaCounts; // FPGA ID -> 节点数量
+
+    for (const auto& sink : net.sinks) {
+        if (sink && sink->fpga) {
+            // 如果sink与source在同一个FPGA上，则忽略
+            if (sink->fpga->id == srcFpgaId) {
+                continue;
+            }
+
+            // 统计每个FPGA上的节点数量
+            sinkFpgaCounts[sink->fpga->id]++;
+        }
+    }
+
+    // 创建连接模式字符串，格式为: "srcFPGA_id:sinkFPGA1_id(count),sinkFPGA2_id(count),..."
+    std::string connectionPattern = std::to_string(srcFpgaId) + ":";
+
+    // 对sink FPGA ID进行排序，确保连接模式的一致性
+    for (const auto& pair : sinkFpgaCounts) {
+        if (connectionPattern.length() > std::to_string(srcFpgaId).length() + 1) {
+            connectionPattern += ",";
+        }
+        connectionPattern += std::to_string(pair.first) + "(" + std::to_string(pair.second) + ")";
+    }
+
+    return connectionPattern;
+}
+
 /**
  * @brief Groups nets based on their FPGA connection patterns.
  * @return A vector of net groups, where each group is a vector of net IDs.
@@ -239,60 +271,229 @@ void Design::generateVisualizationData(const std::string& filename) const {
  *         The connection pattern shows the source FPGA and each sink FPGA with the count of nodes.
  */
 std::vector<std::vector<int>> Design::groupNetsByFpgaConnection() const {
+    // 使用map来存储具有相同FPGA连接模式的net组
+    NetGroupMap connectionGroups = buildNetGroupMap();
+
+    // 将map转换为vector<vector<int>>格式返回
+    std::vector<std::vector<int>> result;
+    for (const auto& group : connectionGroups) {
+        result.push_back(group.second);
+    }
+
+    return result;
+}
+
+// Generic grouping for systems with more than 256 FPGAs, keyed by the pattern string.
+static std::vector<FpgaConnectionGroup> groupNetsGeneric(const std::vector<Net>& nets) {
+    std::vector<FpgaConnectionGroup> groups;
+    std::map<std::string, size_t> groupIndex; // 连接模式 -> 组下标
+
+    for (const auto& net : nets) {
+        std::string pattern = Design::connectionPattern(net);
+        if (pattern.empty()) {
+            continue;
+        }
+
+        auto it = groupIndex.find(pattern);
+        if (it == groupIndex.end()) {
+            FpgaConnectionGroup group;
+            group.src_fpga = net.source->fpga->id;
+            std::map<int, int> sinkFpgaCounts; // FPGA ID -> 节点数量
+            for (const auto& sink : net.sinks) {
+                if (sink && sink->fpga && sink->fpga->id != group.src_fpga) {
+                    sinkFpgaCounts[sink->fpga->id]++;
+                }
+            }
+            group.sink_counts.assign(sinkFpgaCounts.begin(), sinkFpgaCounts.end());
+            it = groupIndex.emplace(pattern, groups.size()).first;
+            groups.push_back(std::move(group));
+        }
+        groups[it->second].net_ids.push_back(net.id);
+    }
+    return groups;
+}
+
+// Picks the bit-mask kernel that fits the FPGA count, or the generic grouping.
+static std::vector<FpgaConnectionGroup> groupNetsBySinkCounts(const std::vector<Net>& nets, size_t num_fpgas) {
+    if (num_fpgas <= FpgaMask<1>::kCapacity) {
+        return groupNetsFixed<1>(nets);
+    }
+    if (num_fpgas <= FpgaMask<4>::kCapacity) {
+        return groupNetsFixed<4>(nets);
+    }
+    return groupNetsGeneric(nets);
+}
+
+// Formats "src:sink1(count),sink2(count)" or, without counts, "src:sink1,sink2".
+static std::string formatPattern(const FpgaConnectionGroup& group, bool with_counts) {
+    std::string pattern = std::to_string(group.src_fpga) + ":";
+    for (size_t i = 0; i < group.sink_counts.size(); ++i) {
+        if (i > 0) {
+            pattern += ",";
+        }
+        pattern += std::to_string(group.sink_counts[i].first);
+        if (with_counts) {
+            pattern += "(" + std::to_string(group.sink_counts[i].second) + ")";
+        }
+    }
+    return pattern;
+}
+
+Design::NetGroupMap Design::buildNetGroupMap() const {
     // 检查必要的数据是否已加载
     if (nets_.empty() || fpgas_.empty()) {
         throw std::logic_error("Grouping Error: Nets and FPGAs must be loaded before grouping.");
     }
-    
-    // 使用map来存储具有相同FPGA连接模式的net组
+
     // 键是一个表示FPGA连接模式的字符串，值是对应的net ID列表
-    std::map<std::string, std::vector<int>> connectionGroups;
-    
-    // 遍历所有net
-    for (const auto& net : nets_) {
-        // 跳过无效的net（没有source或fpga信息）
-        if (!net.source || !net.source->fpga) {
-            continue;
+    // 每个组只生成一次模式字符串，而不是每个net一次
+    NetGroupMap connectionGroups;
+    for (auto& group : groupNetsBySinkCounts(nets_, fpgas_.size())) {
+        connectionGroups[formatPattern(group, true)] = std::move(group.net_ids);
+    }
+    return connectionGroups;
+}
+
+Design::ConsolidatedGroupMap Design::consolidateNetGroups() const {
+    if (nets_.empty() || fpgas_.empty()) {
+        throw std::logic_error("Grouping Error: Nets and FPGAs must be loaded before grouping.");
+    }
+
+    // 同一次分组同时生成两级键：
+    // "src:sink1,sink2"（忽略数量）以及 "src:sink1(count),sink2(count)"
+    ConsolidatedGroupMap consolidated;
+    for (auto& group : groupNetsBySinkCounts(nets_, fpgas_.size())) {
+        consolidated[formatPattern(group, false)][formatPattern(group, true)] = std::move(group.net_ids);
+    }
+    return consolidated;
+}
+
+// Hash of the node IDs of a net (source first, then sinks in file order).
+static uint64_t nodeHash(const Net& net) {
+    uint64_t h = net.source ? static_cast<uint64_t>(net.source->id) : 0;
+    for (const auto& sink : net.sinks) {
+        h = (h ^ static_cast<uint64_t>(sink ? sink->id : -1)) * 0x100000001b3ULL;
+    }
+    return h ^ (h >> 32);   // The low bits pick the hash table slot.
+}
+
+// Whether two nets connect the same nodes; the nodes may belong to different designs.
+// moved is set if any of those nodes is placed on a different FPGA in b than in a.
+static bool sameNodes(const Net& a, const Net& b, bool& moved) {
+    auto fpga_id = [](const Node* node) { return node->fpga ? node->fpga->id : -1; };
+    if (a.sinks.size() != b.sinks.size() || !a.source != !b.source) {
+        return false;
+    }
+    moved = false;
+    if (a.source) {
+        if (a.source->id != b.source->id) {
+            return false;
         }
-        
-        // 获取源FPGA ID
-        int srcFpgaId = net.source->fpga->id;
-        
-        // 收集所有sink所在的FPGA ID，并统计每个FPGA上的节点数量
-        std::map<int, int> sinkFpgaCounts; // FPGA ID -> 节点数量
-        
+        moved = fpga_id(a.source) != fpga_id(b.source);
+    }
+    for (size_t i = 0; i < a.sinks.size(); ++i) {
+        if (a.sinks[i]->id != b.sinks[i]->id) {
+            return false;
+        }
+        moved |= fpga_id(a.sinks[i]) != fpga_id(b.sinks[i]);
+    }
+    return true;
+}
+
+// Generic check for systems with more than 256 FPGAs: same source FPGA and sink FPGA set.
+static bool sameFpgaConnectionGeneric(const Net& a, const Net& b) {
+    auto fpga_set = [](const Net& net) {
+        std::vector<int> ids;
+        int src = net.source && net.source->fpga ? net.source->fpga->id : -1;
+        ids.push_back(src);
         for (const auto& sink : net.sinks) {
-            if (sink && sink->fpga) {
-                // 如果sink与source在同一个FPGA上，则忽略
-                if (sink->fpga->id == srcFpgaId) {
-                    continue;
+            if (sink && sink->fpga && sink->fpga->id != src) {
+                ids.push_back(sink->fpga->id);
+            }
+        }
+        std::sort(ids.begin() + 1, ids.end());
+        ids.erase(std::unique(ids.begin() + 1, ids.end()), ids.end());
+        return ids;
+    };
+    return fpga_set(a) == fpga_set(b);
+}
+
+Design::NetDiff Design::diffNets(const Design& previous) const {
+    const auto& old_nets = previous.getNets();
+    NetDiff diff;
+    diff.previous_ids.assign(nets_.size(), 0);
+    std::vector<char> used(old_nets.size(), 0);
+    std::vector<char> moved(nets_.size(), 0);
+
+    // Previous net indices by node hash (open addressing), built on the first mismatch.
+    std::vector<int> table;
+    std::vector<uint64_t> old_hashes;
+    size_t mask = 0;
+    auto find_previous = [&](const Net& net, bool& moved_out) {
+        if (table.empty()) {
+            size_t size = 1;
+            while (size < 2 * old_nets.size()) {
+                size <<= 1;
+            }
+            table.assign(size, -1);
+            mask = size - 1;
+            old_hashes.resize(old_nets.size());
+            for (size_t k = 0; k < old_nets.size(); ++k) {
+                old_hashes[k] = nodeHash(old_nets[k]);
+                size_t slot = old_hashes[k] & mask;
+                while (table[slot] >= 0) {
+                    slot = (slot + 1) & mask;
                 }
-                
-                // 统计每个FPGA上的节点数量
-                sinkFpgaCounts[sink->fpga->id]++;
+                table[slot] = static_cast<int>(k);
             }
         }
-        
-        // 创建连接模式字符串，格式为: "srcFPGA_id:sinkFPGA1_id(count),sinkFPGA2_id(count),..."
-        std::string connectionPattern = std::to_string(srcFpgaId) + ":";
-        
-        // 对sink FPGA ID进行排序，确保连接模式的一致性
-        for (const auto& pair : sinkFpgaCounts) {
-            if (connectionPattern.length() > std::to_string(srcFpgaId).length() + 1) {
-                connectionPattern += ",";
+        uint64_t hash = nodeHash(net);
+        for (size_t slot = hash & mask; table[slot] >= 0; slot = (slot + 1) & mask) {
+            int k = table[slot];
+            if (!used[k] && old_hashes[k] == hash && sameNodes(old_nets[k], net, moved_out)) {
+                return k;
             }
-            connectionPattern += std::to_string(pair.first) + "(" + std::to_string(pair.second) + ")";
         }
-        
-        // 将当前net ID添加到对应的连接模式组中
-        connectionGroups[connectionPattern].push_back(net.id);
+        return -1;
+    };
+
+    // Nets are compared in file order; after inserted or deleted lines the hash
+    // lookup finds the previous position and the sequential comparison resumes there.
+    size_t next = 0;
+    for (size_t i = 0; i < nets_.size(); ++i) {
+        bool node_moved = false;
+        int k = -1;
+        if (next < old_nets.size() && !used[next] && sameNodes(old_nets[next], nets_[i], node_moved)) {
+            k = static_cast<int>(next);
+        } else if (!old_nets.empty()) {
+            k = find_previous(nets_[i], node_moved);
+        }
+        if (k >= 0) {
+            diff.previous_ids[i] = old_nets[k].id;
+            used[k] = 1;
+            moved[i] = node_moved;
+            next = k + 1;
+        }
     }
-    
-    // 将map转换为vector<vector<int>>格式返回
-    std::vector<std::vector<int>> result;
-    for (const auto& group : connectionGroups) {
-        result.push_back(group.second);
+
+    // A matched net keeps its route unless a node move changed its source FPGA or sink FPGA set.
+    size_t num_fpgas = fpgas_.size();
+    for (size_t i = 0; i < nets_.size(); ++i) {
+        int previous_id = diff.previous_ids[i];
+        bool same = previous_id && !moved[i];
+        if (previous_id && moved[i]) {
+            const Net& old_net = old_nets[previous_id - 1];
+            if (num_fpgas <= FpgaMask<1>::kCapacity) {
+                same = sameFpgaConnectionFixed<1>(old_net, nets_[i]);
+            } else if (num_fpgas <= FpgaMask<4>::kCapacity) {
+                same = sameFpgaConnectionFixed<4>(old_net, nets_[i]);
+            } else {
+                same = sameFpgaConnectionGeneric(old_net, nets_[i]);
+            }
+        }
+        if (!same) {
+            diff.changed.push_back(nets_[i].id);
+        }
     }
-    
-    return result;
+    return diff;
 }
@@ -1,7 +1,10 @@
 #include "FastParser.hpp"
+#include <limits>
 
 
-FastParser::FastParser(const std::string& filename) : buffer_(nullptr), current_pos_(nullptr), file_size_(0) {
+FastParser::FastParser(const std::string& filename)
+    : filename_(filename), buffer_(nullptr), current_pos_(nullptr), line_end_(nullptr), file_size_(0),
+      line_number_(0) {
     // Open the file in binary read mode.
     FILE* file = fopen(filename.c_str(), "rb");
     if (!file) {
@@ -35,52 +38,141 @@ FastParser::~FastParser() {
     delete[] buffer_;
 }
 
-bool FastParser::isEOF() const {
-    // The end is reached if the current position is at or beyond the end of the file content.
-    return current_pos_ >= buffer_ + file_size_;
+void FastParser::fail(const std::string& message) const {
+    throw std::runtime_error("FastParser Error: " + filename_ + ":" + std::to_string(line_number_) + ": " + message);
 }
 
-void FastParser::skipWhitespace() {
-    while (*current_pos_ && (*current_pos_ == ' ' || *current_pos_ == '\n' || *current_pos_ == '\r' || *current_pos_ == '\t')) {
+void FastParser::skipBlanks() {
+    while (current_pos_ < line_end_ && (*current_pos_ == ' ' || *current_pos_ == '\t' || *current_pos_ == '\r')) {
         current_pos_++;
     }
 }
 
-char FastParser::peekNextNonWhitespaceChar() {
-    // Save current position
-    char* original_pos = current_pos_;
-    skipWhitespace();
-    char next_char = isEOF() ? '\0' : *current_pos_;
-    // Restore position, since this is a peek.
-    current_pos_ = original_pos;
-    return next_char;
+bool FastParser::nextLine() {
+    char* end = buffer_ + file_size_;
+
+    // Drop the rest of the current line.
+    if (line_end_) {
+        current_pos_ = line_end_ < end ? line_end_ + 1 : end;
+    }
+
+    while (current_pos_ < end) {
+        line_number_++;
+        char* newline = static_cast<char*>(std::memchr(current_pos_, '\n', end - current_pos_));
+        line_end_ = newline ? newline : end;
+
+        skipBlanks();
+        if (current_pos_ < line_end_) {
+            return true;
+        }
+        // Blank line: continue with the next one.
+        current_pos_ = line_end_ < end ? line_end_ + 1 : end;
+    }
+
+    line_end_ = end;
+    return false;
 }
 
-int FastParser::parseInt() {
-    skipWhitespace();
-    int val = 0;
+bool FastParser::atLineEnd() {
+    skipBlanks();
+    return current_pos_ >= line_end_;
+}
+
+void FastParser::expectLineEnd() {
+    if (!atLineEnd()) {
+        fail(std::string("unexpected '") + *current_pos_ + "' after the end of the record");
+    }
+}
+
+char FastParser::peekChar() {
+    skipBlanks();
+    return current_pos_ < line_end_ ? *current_pos_ : '\0';
+}
+
+bool FastParser::acceptChar(char c) {
+    if (peekChar() == c) {
+        current_pos_++;
+        return true;
+    }
+    return false;
+}
+
+void FastParser::expectChar(char c) {
+    if (!acceptChar(c)) {
+        fail(std::string("expected '") + c + "'");
+    }
+}
+
+void FastParser::expectWord(const char* word) {
+    skipBlanks();
+    size_t len = std::strlen(word);
+    if ((size_t)(line_end_ - current_pos_) < len || std::strncmp(current_pos_, word, len) != 0) {
+        fail(std::string("expected \"") + word + "\"");
+    }
+    current_pos_ += len;
+}
 
+int FastParser::readInt() {
+    skipBlanks();
+    if (current_pos_ >= line_end_ || *current_pos_ < '0' || *current_pos_ > '9') {
+        fail("expected an integer");
+    }
+
+    int val = 0;
     while (*current_pos_ >= '0' && *current_pos_ <= '9') {
-        val = val * 10 + (*current_pos_ - '0');
+        int digit = *current_pos_ - '0';
+        if (val > (std::numeric_limits<int>::max() - digit) / 10) {
+            fail("integer is too large");
+        }
+        val = val * 10 + digit;
         current_pos_++;
     }
     return val;
 }
 
-int FastParser::parseId(char prefix) {
-    skipWhitespace();
+int FastParser::readId(char prefix) {
+    skipBlanks();
     // Skip the prefix character, e.g., 'F' or 'g'.
-    if (*current_pos_ == prefix) {
-        current_pos_++;
+    if (current_pos_ >= line_end_ || *current_pos_ != prefix) {
+        fail(std::string("expected an ID starting with '") + prefix + "'");
     }
-    return parseInt();
+    current_pos_++;
+    return readInt();
 }
 
-void FastParser::skipChar(char c) {
-    skipWhitespace();
-    if (*current_pos_ == c) {
-        current_pos_++;
+double FastParser::readDouble() {
+    skipBlanks();
+    if (current_pos_ >= line_end_) {
+        fail("expected a number");
     }
-    skipWhitespace();
-}
 
+    // Fast path for plain decimals like "3" or "41.2": with at most 15 digits the
+    // mantissa and the power of ten are exact, so one division rounds like strtod.
+    static const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+                                    1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    char* p = current_pos_;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int fraction_digits = 0;
+    for (; p < line_end_ && *p >= '0' && *p <= '9'; ++p, ++digits) {
+        mantissa = mantissa * 10 + (*p - '0');
+    }
+    if (p < line_end_ && *p == '.') {
+        for (++p; p < line_end_ && *p >= '0' && *p <= '9'; ++p, ++digits, ++fraction_digits) {
+            mantissa = mantissa * 10 + (*p - '0');
+        }
+    }
+    bool plain = digits > 0 && digits <= 15 && (p >= line_end_ || (*p != 'e' && *p != 'E'));
+    if (plain) {
+        current_pos_ = p;
+        return static_cast<double>(mantissa) / kPow10[fraction_digits];
+    }
+
+    char* end = current_pos_;
+    double val = std::strtod(current_pos_, &end);
+    if (end == current_pos_ || end > line_end_ || !std::isfinite(val)) {
+        fail("expected a finite number");
+    }
+    current_pos_ = end;
+    return val;
+}
@@ -0,0 +1,623 @@
+#include "Optimizer.hpp"
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+// Weight of the average delay and of ratio overflow in the annealing cost.
+const double kAverageDelayWeight = 0.1;
+const double kOverflowPenalty = 1000.0;
+// Exponents tried when skewing ratios towards critical groups.
+const double kRebalanceExponents[] = {1.0, 0.5, 0.25};
+const int kRebalanceRounds = 4;
+
+// A consolidated net group; all members share one route.
+struct OptGroup {
+    int src;                       // Source FPGA index.
+    int size;                      // Number of member nets.
+    std::vector<int> net_ids;
+};
+
+// Routing state of one chain. Paths hold 0-based FPGA indices.
+struct ChainState {
+    std::vector<std::vector<std::vector<int>>> paths;   // Per group: one path per sink FPGA.
+    std::vector<int> load;                              // Nets per directed edge, row-major.
+    std::vector<double> delay;                          // Per group, under uniform ratios.
+    double max_delay = 0.0;
+    double cost = 0.0;
+};
+
+// Physical links of the topology, shared by all chains.
+struct LinkGraph {
+    std::vector<std::vector<int>> neighbors;   // Per FPGA index: linked FPGA indices, ascending.
+    std::vector<int> link_of_edge;             // Row-major directed edge -> link index, -1 without channels.
+    size_t num_links = 0;
+};
+
+// Simulated annealing over group paths. A move only touches the edges whose load changes
+// and the groups routed over edges whose ratio changes, so its cost does not grow with
+// the size of the topology or the number of groups. Ratios are integers, so the running
+// sums below stay exact and match a full evaluate().
+class Annealer {
+public:
+    Annealer(const std::vector<OptGroup>& groups, const std::vector<int>& channels, const LinkGraph& links,
+             size_t num_fpgas, size_t total_nets)
+        : groups_(groups), channels_(channels), links_(links), n_(num_fpgas), total_nets_(total_nets),
+          ratio_(num_fpgas * num_fpgas, 1.0), edge_mask_(num_fpgas * num_fpgas, 0),
+          link_groups_(links.num_links), group_mark_(groups.size(), 0), dist_(num_fpgas),
+          parent_(num_fpgas), done_(num_fpgas) {}
+
+    // Adds (sign = 1) or removes (sign = -1) a group's load, counting each edge once.
+    void updateGroupLoad(ChainState& state, size_t g, int sign) {
+        groupEdges(state, g, scratch_edges_);
+        for (int e : scratch_edges_) {
+            state.load[e] += sign * groups_[g].size;
+        }
+    }
+
+    // Recomputes ratios, group delays and the cost of a state from scratch.
+    void evaluate(ChainState& state) {
+        overflow_ = 0.0;
+        for (size_t e = 0; e < ratio_.size(); ++e) {
+            ratio_[e] = edgeRatio(state, e);
+            overflow_ += std::max(0.0, ratio_[e] - kMaxTdmRatio);
+        }
+
+        for (auto& users : link_groups_) {
+            users.clear();
+        }
+        delay_count_.clear();
+        weighted_sum_ = 0.0;
+        for (size_t g = 0; g < groups_.size(); ++g) {
+            groupEdges(state, g, scratch_edges_);
+            for (int e : scratch_edges_) {
+                link_groups_[links_.link_of_edge[e]].push_back(static_cast<int>(g));
+            }
+            state.delay[g] = groupDelay(state, g);
+            delay_count_[state.delay[g]]++;
+            weighted_sum_ += state.delay[g] * groups_[g].size;
+        }
+        updateCost(state);
+        rebuildCritical(state);
+    }
+
+    // Cheapest path from src to dst under post-move ratios, avoiding the banned edge.
+    // Returns an empty path if dst is unreachable.
+    std::vector<int> findPath(const ChainState& state, size_t g, int src, int dst, int banned_edge) {
+        // Edges the group keeps using elsewhere do not gain extra load.
+        for (size_t p = 0; p < state.paths[g].size(); ++p) {
+            const auto& path = state.paths[g][p];
+            for (size_t k = 0; k + 1 < path.size(); ++k) {
+                edge_mask_[path[k] * n_ + path[k + 1]] = 1;
+            }
+        }
+
+        // Dijkstra over the physical links; ties go to the lower FPGA index.
+        std::fill(dist_.begin(), dist_.end(), std::numeric_limits<double>::infinity());
+        std::fill(parent_.begin(), parent_.end(), -1);
+        std::fill(done_.begin(), done_.end(), 0);
+        using Entry = std::pair<double, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        dist_[src] = 0.0;
+        queue.push({0.0, src});
+        while (!queue.empty()) {
+            int u = queue.top().second;
+            queue.pop();
+            if (done_[u]) {
+                continue;
+            }
+            if (u == dst) {
+                break;
+            }
+            done_[u] = 1;
+            for (int v : links_.neighbors[u]) {
+                size_t e = u * n_ + v;
+                if (done_[v] || static_cast<int>(e) == banned_edge) {
+                    continue;
+                }
+                int load = state.load[e] + (edge_mask_[e] ? 0 : groups_[g].size);
+                double w = std::ceil(static_cast<double>(load) / channels_[e]);
+                if (dist_[u] + w < dist_[v]) {
+                    dist_[v] = dist_[u] + w;
+                    parent_[v] = u;
+                    queue.push({dist_[v], v});
+                }
+            }
+        }
+
+        for (const auto& path : state.paths[g]) {
+            for (size_t k = 0; k + 1 < path.size(); ++k) {
+                edge_mask_[path[k] * n_ + path[k + 1]] = 0;
+            }
+        }
+
+        std::vector<int> path;
+        if (parent_[dst] < 0) {
+            return path;
+        }
+        for (int v = dst; v != src; v = parent_[v]) {
+            path.push_back(v);
+        }
+        path.push_back(src);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Runs one annealing chain and returns its best state.
+    ChainState run(const ChainState& initial, int iterations, unsigned seed, double start_temperature) {
+        std::mt19937 rng(seed);
+        ChainState state = initial;
+        evaluate(state);
+
+        // The best state is the current one with the moves accepted since then undone,
+        // so it is never copied.
+        struct Move {
+            size_t g;
+            size_t p;
+            std::vector<int> old_path;
+        };
+        std::vector<Move> since_best;
+        double best_max_delay = state.max_delay;
+        double best_cost = state.cost;
+
+        std::vector<size_t> movable;
+        for (size_t g = 0; g < groups_.size(); ++g) {
+            if (!state.paths[g].empty()) {
+                movable.push_back(g);
+            }
+        }
+        if (movable.empty() || iterations <= 0) {
+            return state;
+        }
+
+        double temperature = start_temperature * std::max(state.cost, 1.0);
+        double cooling = std::pow(1e-3, 1.0 / iterations);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::vector<int> old_edges;
+        std::vector<int> new_edges;
+
+        for (int it = 0; it < iterations; ++it, temperature *= cooling) {
+            // Mostly pick a group on the critical delay, sometimes any group.
+            const std::vector<size_t>& pool = (!critical_.empty() && unit(rng) < 0.8) ? critical_ : movable;
+            size_t g = pool[std::uniform_int_distribution<size_t>(0, pool.size() - 1)(rng)];
+
+            // Its slowest path and the hop with the highest ratio on it.
+            auto& paths = state.paths[g];
+            size_t p = 0;
+            double slowest = -1.0;
+            for (size_t i = 0; i < paths.size(); ++i) {
+                double d = 0.0;
+                for (size_t k = 0; k + 1 < paths[i].size(); ++k) {
+                    d += ratio_[paths[i][k] * n_ + paths[i][k + 1]];
+                }
+                if (d > slowest) {
+                    slowest = d;
+                    p = i;
+                }
+            }
+            int banned = -1;
+            double worst_ratio = 0.0;
+            for (size_t k = 0; k + 1 < paths[p].size(); ++k) {
+                int e = paths[p][k] * static_cast<int>(n_) + paths[p][k + 1];
+                if (ratio_[e] > worst_ratio) {
+                    worst_ratio = ratio_[e];
+                    banned = e;
+                }
+            }
+
+            std::vector<int> old_path = paths[p];
+            groupEdges(state, g, old_edges);
+            updateGroupLoad(state, g, -1);
+            std::vector<int> new_path = findPath(state, g, groups_[g].src, old_path.back(), banned);
+            if (new_path.empty() || new_path == old_path) {
+                updateGroupLoad(state, g, 1);
+                continue;
+            }
+            paths[p] = new_path;
+            updateGroupLoad(state, g, 1);
+            groupEdges(state, g, new_edges);
+
+            double old_cost = state.cost;
+            applyMove(state, g, old_edges, new_edges);
+
+            double delta = state.cost - old_cost;
+            if (delta <= 0.0 || unit(rng) < std::exp(-delta / std::max(temperature, 1e-12))) {
+                if (state.max_delay < best_max_delay ||
+                    (state.max_delay == best_max_delay && state.cost < best_cost)) {
+                    best_max_delay = state.max_delay;
+                    best_cost = state.cost;
+                    since_best.clear();
+                } else {
+                    since_best.push_back({g, p, std::move(old_path)});
+                }
+                continue;
+            }
+
+            // Rejected: restore the previous path and undo the move the same way.
+            updateGroupLoad(state, g, -1);
+            paths[p] = std::move(old_path);
+            updateGroupLoad(state, g, 1);
+            applyMove(state, g, new_edges, old_edges);
+        }
+
+        for (auto it = since_best.rbegin(); it != since_best.rend(); ++it) {
+            updateGroupLoad(state, it->g, -1);
+            state.paths[it->g][it->p] = std::move(it->old_path);
+            updateGroupLoad(state, it->g, 1);
+        }
+        evaluate(state);
+        return state;
+    }
+
+private:
+    // The distinct directed edges used by a group's paths, ascending.
+    void groupEdges(const ChainState& state, size_t g, std::vector<int>& edges) const {
+        edges.clear();
+        for (const auto& path : state.paths[g]) {
+            for (size_t k = 0; k + 1 < path.size(); ++k) {
+                edges.push_back(path[k] * static_cast<int>(n_) + path[k + 1]);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    }
+
+    double edgeRatio(const ChainState& state, size_t e) const {
+        if (channels_[e] > 0 && state.load[e] > 0) {
+            return std::ceil(static_cast<double>(state.load[e]) / channels_[e]);
+        }
+        return 1.0;
+    }
+
+    double groupDelay(const ChainState& state, size_t g) const {
+        double delay = 0.0;
+        for (const auto& path : state.paths[g]) {
+            double d = 0.0;
+            for (size_t k = 0; k + 1 < path.size(); ++k) {
+                d += ratio_[path[k] * n_ + path[k + 1]];
+            }
+            delay = std::max(delay, d);
+        }
+        return delay;
+    }
+
+    void updateCost(ChainState& state) const {
+        state.max_delay = delay_count_.empty() ? 0.0 : delay_count_.rbegin()->first;
+        state.cost = state.max_delay + kAverageDelayWeight * weighted_sum_ / std::max<size_t>(total_nets_, 1) +
+                     kOverflowPenalty * overflow_;
+    }
+
+    void setDelay(ChainState& state, size_t g, double delay) {
+        auto it = delay_count_.find(state.delay[g]);
+        if (--it->second == 0) {
+            delay_count_.erase(it);
+        }
+        delay_count_[delay]++;
+        weighted_sum_ += (delay - state.delay[g]) * groups_[g].size;
+        state.delay[g] = delay;
+    }
+
+    // Brings ratios, delays and the cost up to date after group g moved from the edges
+    // old_edges to new_edges (both ascending); state.load must already reflect the move.
+    void applyMove(ChainState& state, size_t g, const std::vector<int>& old_edges,
+                   const std::vector<int>& new_edges) {
+        affected_.clear();
+        group_mark_[g] = 1;
+        affected_.push_back(g);
+
+        // Only edges the group left or joined change load.
+        changed_edges_.clear();
+        std::set_symmetric_difference(old_edges.begin(), old_edges.end(), new_edges.begin(), new_edges.end(),
+                                      std::back_inserter(changed_edges_));
+        for (int e : changed_edges_) {
+            double ratio = edgeRatio(state, e);
+            if (ratio == ratio_[e]) {
+                continue;
+            }
+            overflow_ += std::max(0.0, ratio - kMaxTdmRatio) - std::max(0.0, ratio_[e] - kMaxTdmRatio);
+            ratio_[e] = ratio;
+            for (int user : link_groups_[links_.link_of_edge[e]]) {
+                if (!group_mark_[user]) {
+                    group_mark_[user] = 1;
+                    affected_.push_back(user);
+                }
+            }
+        }
+
+        // Update the groups using each edge.
+        for (int e : changed_edges_) {
+            std::vector<int>& users = link_groups_[links_.link_of_edge[e]];
+            if (std::binary_search(new_edges.begin(), new_edges.end(), e)) {
+                users.push_back(static_cast<int>(g));
+            } else {
+                auto it = std::find(users.begin(), users.end(), static_cast<int>(g));
+                *it = users.back();
+                users.pop_back();
+            }
+        }
+
+        for (size_t a : affected_) {
+            group_mark_[a] = 0;
+            setDelay(state, a, groupDelay(state, a));
+        }
+        updateCost(state);
+
+        if (state.max_delay != critical_delay_) {
+            rebuildCritical(state);
+            return;
+        }
+        for (size_t a : affected_) {
+            bool is_critical = !state.paths[a].empty() && state.delay[a] >= state.max_delay;
+            auto it = std::lower_bound(critical_.begin(), critical_.end(), a);
+            bool was_critical = it != critical_.end() && *it == a;
+            if (is_critical && !was_critical) {
+                critical_.insert(it, a);
+            } else if (!is_critical && was_critical) {
+                critical_.erase(it);
+            }
+        }
+    }
+
+    // Collects the movable groups on the max delay, ascending.
+    void rebuildCritical(const ChainState& state) {
+        critical_.clear();
+        critical_delay_ = state.max_delay;
+        for (size_t g = 0; g < groups_.size(); ++g) {
+            if (!state.paths[g].empty() && state.delay[g] >= state.max_delay) {
+                critical_.push_back(g);
+            }
+        }
+    }
+
+    const std::vector<OptGroup>& groups_;
+    const std::vector<int>& channels_;
+    const LinkGraph& links_;
+    size_t n_;
+    size_t total_nets_;
+    std::vector<double> ratio_;          // Uniform ratio per directed edge of the current state.
+    std::vector<char> edge_mask_;        // Scratch: edges of the group being moved.
+    std::vector<std::vector<int>> link_groups_;   // Per link: the groups routed over it.
+    std::map<double, int> delay_count_;  // Number of groups per delay; the last key is the max delay.
+    double weighted_sum_ = 0.0;          // Sum of delay * size over all groups.
+    double overflow_ = 0.0;              // Sum of ratio excess over kMaxTdmRatio.
+    std::vector<char> group_mark_;       // Scratch: groups already in affected_.
+    std::vector<size_t> affected_;       // Scratch: groups whose delay may have changed.
+    std::vector<int> changed_edges_;     // Scratch: edges whose load changed.
+    std::vector<size_t> critical_;       // Movable groups with delay >= critical_delay_, ascending.
+    double critical_delay_ = 0.0;        // The max delay critical_ was collected for.
+    std::vector<int> scratch_edges_;
+    std::vector<double> dist_;           // Scratch for findPath().
+    std::vector<int> parent_;
+    std::vector<char> done_;
+};
+
+} // namespace
+
+PostOptimizer::PostOptimizer(const Design& design) : design_(design) {}
+
+double PostOptimizer::optimize(Router& router, const Design::ConsolidatedGroupMap& net_groups,
+                               const OptimizerOptions& options, ThreadPool* pool, size_t max_tasks) {
+    const auto& topo = design_.getTopology();
+    size_t n = topo.size();
+    const auto& routes = router.getRoutes();
+
+    std::vector<int> channels(n * n, 0);
+    LinkGraph links;
+    links.neighbors.resize(n);
+    links.link_of_edge.assign(n * n, -1);
+    for (size_t u = 0; u < n; ++u) {
+        for (size_t v = 0; v < n; ++v) {
+            channels[u * n + v] = topo[u][v];
+            if (topo[u][v] > 0) {
+                links.neighbors[u].push_back(static_cast<int>(v));
+                links.link_of_edge[u * n + v] = static_cast<int>(links.num_links++);
+            }
+        }
+    }
+
+    // One optimization group per source FPGA + sink FPGA set, seeded from the router.
+    std::vector<OptGroup> groups;
+    ChainState initial;
+    size_t total_nets = 0;
+    for (const auto& consolidated : net_groups) {
+        OptGroup group;
+        for (const auto& inner : consolidated.second) {
+            group.net_ids.insert(group.net_ids.end(), inner.second.begin(), inner.second.end());
+        }
+        auto it = routes.find(group.net_ids.front());
+        if (it == routes.end() || it->second.paths.empty()) {
+            continue; // Nets without remote sinks are not routed.
+        }
+        group.src = it->second.paths.front().front() - 1;
+        group.size = static_cast<int>(group.net_ids.size());
+        total_nets += group.net_ids.size();
+
+        std::vector<std::vector<int>> paths;
+        for (const auto& path : it->second.paths) {
+            paths.emplace_back();
+            for (size_t k = 0; k < path.size(); ++k) {
+                if (k > 0 && topo[path[k - 1] - 1][path[k] - 1] <= 0) {
+                    return router.maxDelay(); // Only legal routings are post-optimized.
+                }
+                paths.back().push_back(path[k] - 1);
+            }
+        }
+        initial.paths.push_back(std::move(paths));
+        groups.push_back(std::move(group));
+    }
+    if (groups.empty()) {
+        return router.maxDelay();
+    }
+
+    initial.load.assign(n * n, 0);
+    initial.delay.assign(groups.size(), 0.0);
+    {
+        Annealer annealer(groups, channels, links, n, total_nets);
+        for (size_t g = 0; g < groups.size(); ++g) {
+            annealer.updateGroupLoad(initial, g, 1);
+        }
+    }
+
+    // Independent chains, one seed each; the best max delay wins.
+    size_t num_chains = std::max<size_t>(options.chains, 1);
+    std::vector<ChainState> results(num_chains);
+    auto run_chain = [&](size_t c) {
+        Annealer annealer(groups, channels, links, n, total_nets);
+        results[c] = annealer.run(initial, options.iterations, options.seed + static_cast<unsigned>(c),
+                                  options.start_temperature);
+    };
+    if (pool) {
+        pool->parallelFor(num_chains, std::min(num_chains, std::max<size_t>(max_tasks, 1)), run_chain);
+    } else {
+        for (size_t c = 0; c < num_chains; ++c) {
+            run_chain(c);
+        }
+    }
+
+    size_t best = 0;
+    for (size_t c = 1; c < num_chains; ++c) {
+        if (results[c].max_delay < results[best].max_delay ||
+            (results[c].max_delay == results[best].max_delay && results[c].cost < results[best].cost)) {
+            best = c;
+        }
+    }
+    const ChainState& state = results[best];
+
+    // --- TDM ratio rebalancing on the best routing ---
+    // Every (group, edge) gets its own ratio; start from the uniform ones.
+    std::unordered_map<int, std::vector<size_t>> edge_groups;   // Edge -> groups using it (once each).
+    for (size_t g = 0; g < groups.size(); ++g) {
+        std::vector<int> edges;
+        for (const auto& path : state.paths[g]) {
+            for (size_t k = 0; k + 1 < path.size(); ++k) {
+                edges.push_back(path[k] * static_cast<int>(n) + path[k + 1]);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        for (int e : edges) {
+            edge_groups[e].push_back(g);
+        }
+    }
+
+    // ratios[g] maps an edge to the ratio group g uses on it.
+    std::vector<std::unordered_map<int, double>> ratios(groups.size());
+    for (const auto& entry : edge_groups) {
+        double uniform = std::max(1.0, std::ceil(static_cast<double>(state.load[entry.first]) / channels[entry.first]));
+        for (size_t g : entry.second) {
+            ratios[g][entry.first] = uniform;
+        }
+    }
+
+    auto group_delays = [&](const std::vector<std::unordered_map<int, double>>& r, std::vector<double>& delays) {
+        double max_delay = 0.0;
+        for (size_t g = 0; g < groups.size(); ++g) {
+            double delay = 0.0;
+            for (const auto& path : state.paths[g]) {
+                double d = 0.0;
+                for (size_t k = 0; k + 1 < path.size(); ++k) {
+                    d += r[g].at(path[k] * static_cast<int>(n) + path[k + 1]);
+                }
+                delay = std::max(delay, d);
+            }
+            delays[g] = delay;
+            max_delay = std::max(max_delay, delay);
+        }
+        return max_delay;
+    };
+
+    std::vector<double> delays(groups.size());
+    double max_delay = group_delays(ratios, delays);
+
+    for (int round = 0; round < kRebalanceRounds; ++round) {
+        bool improved = false;
+        for (double exponent : kRebalanceExponents) {
+            // Weight w_g >= 1 grows with the group's slack; ratio = ceil(lambda_e * w_g), where
+            // lambda_e = sum(size_g / w_g) / channels keeps sum(size_g / ratio) within the channels.
+            std::vector<double> weight(groups.size(), 1.0);
+            for (size_t g = 0; g < groups.size(); ++g) {
+                if (delays[g] > 0.0) {
+                    weight[g] = std::pow(max_delay / delays[g], exponent);
+                }
+            }
+
+            std::vector<std::unordered_map<int, double>> trial(groups.size());
+            bool feasible = true;
+            for (const auto& entry : edge_groups) {
+                int e = entry.first;
+                double lambda = 0.0;
+                for (size_t g : entry.second) {
+                    lambda += groups[g].size / weight[g];
+                }
+                lambda /= channels[e];
+
+                double used = 0.0;
+                for (size_t g : entry.second) {
+                    double r = std::max(1.0, std::ceil(lambda * weight[g] - 1e-9));
+                    if (r > kMaxTdmRatio) {
+                        feasible = false;
+                    }
+                    trial[g][e] = r;
+                    used += groups[g].size / r;
+                }
+                if (used > channels[e] + 1e-9) {
+                    feasible = false;
+                }
+                if (!feasible) {
+                    break;
+                }
+            }
+            if (!feasible) {
+                continue;
+            }
+
+            std::vector<double> trial_delays(groups.size());
+            double trial_max = group_delays(trial, trial_delays);
+            if (trial_max < max_delay) {
+                ratios = std::move(trial);
+                delays = std::move(trial_delays);
+                max_delay = trial_max;
+                improved = true;
+                break;
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+
+    // Keep the router's solution if annealing and rebalancing did not help.
+    if (max_delay >= router.maxDelay()) {
+        return router.maxDelay();
+    }
+
+    std::map<int, NetRoute> optimized;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        NetRoute route;
+        for (const auto& path : state.paths[g]) {
+            std::vector<int> fpga_ids;
+            std::vector<double> hop_ratios;
+            for (size_t k = 0; k < path.size(); ++k) {
+                fpga_ids.push_back(path[k] + 1);
+                if (k + 1 < path.size()) {
+                    hop_ratios.push_back(ratios[g].at(path[k] * static_cast<int>(n) + path[k + 1]));
+                }
+            }
+            route.paths.push_back(std::move(fpga_ids));
+            route.ratios.push_back(std::move(hop_ratios));
+        }
+        for (int net_id : groups[g].net_ids) {
+            route.net_id = net_id;
+            optimized[net_id] = route;
+        }
+    }
+    // Nets outside the optimized groups keep their routes.
+    for (const auto& entry : routes) {
+        optimized.emplace(entry.first, entry.second);
+    }
+    router.setRoutes(std::move(optimized));
+    return max_delay;
+}
@@ -0,0 +1,118 @@
+#include "Pipeline.hpp"
+#include "Optimizer.hpp"
+#include "Router.hpp"
+#include "Utils.hpp"
+#include "VizExport.hpp"
+
+namespace {
+
+long long elapsedMs(std::chrono::high_resolution_clock::time_point start,
+                    std::chrono::high_resolution_clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+} // namespace
+
+void loadDesign(Design& design, const std::string& info_file, const std::string& fpga_map_file,
+                const std::string& net_file, const std::string& topo_file, bool verbose) {
+    if (verbose) {
+        std::cout << "Loading " << info_file << "..." << std::endl;
+    }
+    design.loadInfo(info_file);
+
+    if (verbose) {
+        std::cout << "Loading " << fpga_map_file << "..." << std::endl;
+    }
+    design.loadFpgaMapping(fpga_map_file);
+
+    if (verbose) {
+        std::cout << "Loading " << net_file << "..." << std::endl;
+    }
+    design.loadNets(net_file);
+
+    if (verbose) {
+        std::cout << "Loading " << topo_file << "..." << std::endl;
+    }
+    design.loadTopo(topo_file);
+}
+
+ValidationReport validateRoutes(const Design& design, const std::string& route_file, ThreadPool* pool,
+                                size_t max_tasks, const std::string& new_topo_file, bool verbose) {
+    auto validate_start = std::chrono::high_resolution_clock::now();
+    Validator validator(design);
+    validator.setThreadPool(pool, max_tasks);
+    if (!new_topo_file.empty()) {
+        validator.loadNewTopo(new_topo_file);
+    }
+    ValidationReport report = validator.validate(route_file);
+    auto validate_end = std::chrono::high_resolution_clock::now();
+
+    if (verbose) {
+        printValidationReport(report);
+        std::cout << "Validation time: " << elapsedMs(validate_start, validate_end) << " milliseconds" << std::endl;
+    }
+    return report;
+}
+
+void runCase(CaseResult& result, ThreadPool& pool, bool verbose) {
+    const std::string prefix = result.case_dir + "/";
+    const std::string& output_dir = result.output_dir;
+    const std::string route_file = output_dir + "design.route.out";
+
+    Design design;
+    auto load_start = std::chrono::high_resolution_clock::now();
+    loadDesign(design, prefix + "design.info", prefix + "design.fpga.out", prefix + "design.net",
+               prefix + "design.topo", verbose);
+    auto load_end = std::chrono::high_resolution_clock::now();
+    result.nets = design.getNets().size();
+    result.load_ms = elapsedMs(load_start, load_end);
+    if (verbose) {
+        std::cout << "\nAll files parsed successfully!\n" << std::endl;
+        std::cout << "File loading time: " << result.load_ms << " milliseconds" << std::endl;
+    }
+
+    design.generateVisualizationData(output_dir + "visualization_data.json");
+
+    // 一次分组同时得到原始分组和合并分组，供输出文件、布线和后优化共用
+    const Design::ConsolidatedGroupMap net_groups = design.consolidateNetGroups();
+    for (const auto& consolidated : net_groups) {
+        result.groups += consolidated.second.size();
+    }
+    outputNetGroupsToFile(design, net_groups, output_dir + "net_groups.txt");
+    outputConsolidatedNetGroupsToFile(net_groups, output_dir + "net_groups_consolidated.txt");
+
+    auto route_start = std::chrono::high_resolution_clock::now();
+    Router router(design);
+    router.setThreadPool(&pool, result.threads);
+    router.routeAll(net_groups);
+    auto route_end = std::chrono::high_resolution_clock::now();
+    result.route_ms = elapsedMs(route_start, route_end);
+    if (verbose) {
+        std::cout << "Routing time: " << result.route_ms << " milliseconds" << std::endl;
+        std::cout << "Max delay: " << router.maxDelay() << std::endl;
+    }
+
+    // Annealing chains on the routed solution, run in parallel on the pool.
+    auto opt_start = std::chrono::high_resolution_clock::now();
+    OptimizerOptions options;
+    double optimized_delay = PostOptimizer(design).optimize(router, net_groups, options, &pool, result.threads);
+    auto opt_end = std::chrono::high_resolution_clock::now();
+    result.optimize_ms = elapsedMs(opt_start, opt_end);
+    if (verbose) {
+        std::cout << "Post-optimization time: " << result.optimize_ms << " milliseconds" << std::endl;
+        std::cout << "Optimized max delay: " << optimized_delay << std::endl;
+    }
+
+    router.writeRoutes(route_file);
+
+    // Binary export with routed load, precomputed layout and level-of-detail views.
+    exportVisualizationBinary(design, &router.getLoad(), output_dir + "visualization_data.fviz", &pool,
+                              result.threads);
+
+    // The routes were made on design.topo, so they are checked against it.
+    ValidationReport report = validateRoutes(design, route_file, &pool, result.threads, "", verbose);
+    result.max_delay = report.max_delay;
+    if (!report.legal) {
+        result.error = "illegal routes" + (report.errors.empty() ? std::string() : ": " + report.errors.front());
+    }
+}
@@ -0,0 +1,50 @@
+#include "RouteFile.hpp"
+#include "FastParser.hpp"
+
+RouteFile readRouteFile(const std::string& filename, size_t num_nets) {
+    FastParser parser(filename);
+    RouteFile routes;
+    std::vector<char> seen(num_nets + 1, 0);
+
+    // Lines are either "[net N]" headers or "[f1,f2,...] [r1,...]" paths of the last header.
+    while (parser.nextLine()) {
+        parser.expectChar('[');
+        if (parser.peekChar() == 'n') {
+            parser.expectWord("net");
+            int net_id = parser.readInt();
+            parser.expectChar(']');
+            parser.expectLineEnd();
+            if (net_id > 0 && (size_t)net_id <= num_nets) {
+                if (seen[net_id]) {
+                    parser.fail("[net " + std::to_string(net_id) + "] appears more than once");
+                }
+                seen[net_id] = 1;
+            }
+            routes.net_ids.push_back(net_id);
+            routes.net_begin.push_back(routes.path_begin.size());
+            continue;
+        }
+        if (routes.net_ids.empty()) {
+            parser.fail("path found before any [net] header");
+        }
+
+        routes.path_begin.push_back(routes.fpgas.size());
+        routes.ratio_begin.push_back(routes.ratios.size());
+        do {
+            routes.fpgas.push_back(parser.readInt());
+        } while (parser.acceptChar(','));
+        parser.expectChar(']');
+
+        parser.expectChar('[');
+        do {
+            routes.ratios.push_back(parser.readDouble());
+        } while (parser.acceptChar(','));
+        parser.expectChar(']');
+        parser.expectLineEnd();
+    }
+
+    routes.net_begin.push_back(routes.path_begin.size());
+    routes.path_begin.push_back(routes.fpgas.size());
+    routes.ratio_begin.push_back(routes.ratios.size());
+    return routes;
+}
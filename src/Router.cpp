@@ -0,0 +1,460 @@
+#include "Router.hpp"
+#include "RouteFile.hpp"
+#include "FixedKernels.hpp"
+#include <deque>
+
+Router::Router(const Design& design) : design_(design), pool_(nullptr), max_tasks_(1), mask_words_(0) {
+    if (design_.getFpgas().empty() || design_.getTopology().empty()) {
+        throw std::logic_error("Router Error: Design must be loaded before routing.");
+    }
+    size_t num_fpgas = design_.getTopology().size();
+    bfs_parents_.resize(num_fpgas);
+    load_.assign(num_fpgas, std::vector<int>(num_fpgas, 0));
+    dirty_.assign(num_fpgas, std::vector<char>(num_fpgas, 0));
+
+    // Small systems use the bit-mask kernels; larger ones keep the generic search.
+    if (num_fpgas <= FpgaMask<1>::kCapacity) {
+        mask_words_ = 1;
+        adj_masks_ = buildAdjacencyMasks<1>(design_.getTopology());
+    } else if (num_fpgas <= FpgaMask<4>::kCapacity) {
+        mask_words_ = 4;
+        adj_masks_ = buildAdjacencyMasks<4>(design_.getTopology());
+    }
+}
+
+void Router::setThreadPool(ThreadPool* pool, size_t max_tasks) {
+    pool_ = pool;
+    max_tasks_ = std::max<size_t>(max_tasks, 1);
+}
+
+void Router::precomputeParents(const std::vector<int>& src_idxs) {
+    // Each index fills its own cache slot, so the searches can run concurrently.
+    auto search = [&](size_t i) { parentsFrom(src_idxs[i]); };
+    if (pool_) {
+        pool_->parallelFor(src_idxs.size(), max_tasks_, search);
+    } else {
+        for (size_t i = 0; i < src_idxs.size(); ++i) {
+            search(i);
+        }
+    }
+}
+
+const std::vector<int>& Router::parentsFrom(int src_idx) {
+    std::vector<int>& parents = bfs_parents_[src_idx];
+    if (!parents.empty()) {
+        return parents;
+    }
+
+    const auto& topo = design_.getTopology();
+    size_t num_fpgas = topo.size();
+    if (mask_words_ == 1) {
+        bfsParentsFixed<1>(adj_masks_, num_fpgas, src_idx, parents);
+        return parents;
+    }
+    if (mask_words_ == 4) {
+        bfsParentsFixed<4>(adj_masks_, num_fpgas, src_idx, parents);
+        return parents;
+    }
+
+    parents.assign(num_fpgas, -1);
+    parents[src_idx] = src_idx;
+
+    std::deque<int> queue;
+    queue.push_back(src_idx);
+    while (!queue.empty()) {
+        int u = queue.front();
+        queue.pop_front();
+        for (size_t v = 0; v < num_fpgas; ++v) {
+            if (topo[u][v] > 0 && parents[v] == -1) {
+                parents[v] = u;
+                queue.push_back(static_cast<int>(v));
+            }
+        }
+    }
+    return parents;
+}
+
+void Router::collectSinkFpgas(const Net& net, int src_idx, std::vector<int>& sink_idxs) const {
+    if (mask_words_ == 1) {
+        collectSinkFpgasFixed<1>(net, src_idx, sink_idxs);
+    } else if (mask_words_ == 4) {
+        collectSinkFpgasFixed<4>(net, src_idx, sink_idxs);
+    } else {
+        sink_idxs.clear();
+        for (const auto& sink : net.sinks) {
+            if (sink && sink->fpga && sink->fpga->id - 1 != src_idx) {
+                sink_idxs.push_back(sink->fpga->id - 1);
+            }
+        }
+        std::sort(sink_idxs.begin(), sink_idxs.end());
+        sink_idxs.erase(std::unique(sink_idxs.begin(), sink_idxs.end()), sink_idxs.end());
+    }
+}
+
+NetRoute Router::routeNet(const Net& net) {
+    NetRoute route(net.id);
+    if (!net.source || !net.source->fpga) {
+        return route;
+    }
+
+    int src_idx = net.source->fpga->id - 1;
+    std::vector<int> sink_idxs;
+    collectSinkFpgas(net, src_idx, sink_idxs);
+
+    const std::vector<int>& parents = parentsFrom(src_idx);
+    for (int sink_idx : sink_idxs) {
+        if (parents[sink_idx] == -1) {
+            throw std::runtime_error("Routing Error: F" + std::to_string(sink_idx + 1) +
+                                     " is unreachable from F" + std::to_string(src_idx + 1) +
+                                     " (net " + std::to_string(net.id) + ").");
+        }
+        // Walk the BFS tree back to the source, then reverse into source->sink order.
+        std::vector<int> path;
+        for (int v = sink_idx; v != src_idx; v = parents[v]) {
+            path.push_back(v + 1);
+        }
+        path.push_back(src_idx + 1);
+        std::reverse(path.begin(), path.end());
+
+        route.ratios.emplace_back(path.size() - 1, 1.0);
+        route.paths.push_back(std::move(path));
+    }
+    return route;
+}
+
+void Router::routeAll(const Design::ConsolidatedGroupMap& group_map) {
+    routes_.clear();
+    for (auto& row : load_) {
+        std::fill(row.begin(), row.end(), 0);
+    }
+    const auto& nets = design_.getNets();
+
+    // Nets in one consolidated group share source and sink FPGAs, so route one net and copy.
+    std::vector<std::vector<int>> groups;
+    std::vector<int> src_idxs;
+    for (const auto& consolidated : group_map) {
+        groups.emplace_back();
+        for (const auto& group : consolidated.second) {
+            groups.back().insert(groups.back().end(), group.second.begin(), group.second.end());
+        }
+        src_idxs.push_back(nets[groups.back().front() - 1].source->fpga->id - 1);
+    }
+
+    std::sort(src_idxs.begin(), src_idxs.end());
+    src_idxs.erase(std::unique(src_idxs.begin(), src_idxs.end()), src_idxs.end());
+    precomputeParents(src_idxs);
+
+    // With the BFS cache filled, routeNet() only reads shared state.
+    std::vector<NetRoute> group_routes(groups.size());
+    auto route_group = [&](size_t i) { group_routes[i] = routeNet(nets[groups[i].front() - 1]); };
+    if (pool_) {
+        pool_->parallelFor(groups.size(), max_tasks_, route_group);
+    } else {
+        for (size_t i = 0; i < groups.size(); ++i) {
+            route_group(i);
+        }
+    }
+
+    for (size_t i = 0; i < groups.size(); ++i) {
+        NetRoute& route = group_routes[i];
+        if (route.paths.empty()) {
+            continue;
+        }
+        updateLoad(route, static_cast<int>(groups[i].size()));
+        for (int net_id : groups[i]) {
+            route.net_id = net_id;
+            routes_[net_id] = route;
+        }
+    }
+    assignRatios();
+}
+
+size_t Router::reroute(const Design::NetDiff& diff) {
+    const auto& nets = design_.getNets();
+    std::vector<char> changed(nets.size(), 0);
+    for (int net_id : diff.changed) {
+        changed[net_id - 1] = 1;
+    }
+
+    // Index the loaded routes by the net IDs of the previous design. The index is sized
+    // by the IDs the diff refers to, not by the route file; other routes are ripped up below.
+    int max_previous_id = 0;
+    for (int previous_id : diff.previous_ids) {
+        max_previous_id = std::max(max_previous_id, previous_id);
+    }
+    std::vector<std::map<int, NetRoute>::iterator> previous_routes(max_previous_id + 1, routes_.end());
+    for (auto it = routes_.begin(); it != routes_.end() && it->first <= max_previous_id; ++it) {
+        if (it->first > 0 && !it->second.paths.empty()) {
+            previous_routes[it->first] = it;
+        }
+    }
+
+    // Unchanged nets connect the same FPGAs as before, so a kept route must start at the
+    // net's source FPGA and end exactly on its sink FPGAs; otherwise the route file
+    // belongs to another design.
+    std::vector<int> sink_idxs;
+    std::vector<int> ends;
+    auto check_kept = [&](const Net& net, int previous_id, const NetRoute& route) {
+        auto mismatch = [&](const std::string& detail) {
+            throw std::runtime_error("Router Error: base routes do not match base design: net " +
+                                     std::to_string(previous_id) + " " + detail + ".");
+        };
+        int src = net.source->fpga->id;
+        ends.clear();
+        for (const auto& path : route.paths) {
+            if (path.front() != src) {
+                mismatch("starts at F" + std::to_string(path.front()) + " instead of source F" +
+                         std::to_string(src));
+            }
+            ends.push_back(path.back() - 1);
+        }
+        std::sort(ends.begin(), ends.end());
+        ends.erase(std::unique(ends.begin(), ends.end()), ends.end());
+        collectSinkFpgas(net, src - 1, sink_idxs);
+        if (ends != sink_idxs) {
+            mismatch("does not end on its " + std::to_string(sink_idxs.size()) + " sink FPGAs");
+        }
+    };
+
+    // Unchanged nets keep their route under their new ID; the map nodes are moved, not copied.
+    std::map<int, NetRoute> kept;
+    std::vector<int> to_route = diff.changed;
+    for (size_t i = 0; i < nets.size(); ++i) {
+        if (changed[i]) {
+            continue;
+        }
+        int previous_id = diff.previous_ids[i];
+        if (previous_id <= 0 || (size_t)previous_id >= previous_routes.size() ||
+            previous_routes[previous_id] == routes_.end()) {
+            // Not in the previous routes: fine for a local net, otherwise route it now.
+            for (const auto& sink : nets[i].sinks) {
+                if (sink->fpga != nets[i].source->fpga) {
+                    to_route.push_back(nets[i].id);
+                    break;
+                }
+            }
+            continue;
+        }
+        check_kept(nets[i], previous_id, previous_routes[previous_id]->second);
+        auto node = routes_.extract(previous_routes[previous_id]);
+        node.key() = nets[i].id;
+        node.mapped().net_id = nets[i].id;
+        kept.insert(kept.end(), std::move(node));
+    }
+    std::sort(to_route.begin(), to_route.end());
+
+    // Whatever is left belongs to a removed or changed net.
+    for (const auto& entry : routes_) {
+        updateLoad(entry.second, -1);
+    }
+    routes_ = std::move(kept);
+
+    // Nets with the same source FPGA and sink FPGA set share one route.
+    struct RouteGroup {
+        std::vector<int> net_ids;
+        NetRoute route;
+    };
+    std::map<std::vector<int>, RouteGroup> groups;   // (source index, sink indices...) -> group.
+    std::vector<char> needed_src(design_.getTopology().size(), 0);
+    std::vector<int> key;
+    for (int net_id : to_route) {
+        const Net& net = nets[net_id - 1];
+        int src_idx = net.source->fpga->id - 1;
+        collectSinkFpgas(net, src_idx, key);
+        if (key.empty()) {
+            continue;
+        }
+        key.insert(key.begin(), src_idx);
+        groups[key].net_ids.push_back(net_id);
+        needed_src[src_idx] = 1;
+    }
+
+    // Join the route of an unchanged net with the same FPGAs, if there is one.
+    for (const auto& entry : routes_) {
+        const NetRoute& route = entry.second;
+        int src_idx = route.paths.front().front() - 1;
+        if (!needed_src[src_idx]) {
+            continue;
+        }
+        key.assign(1, src_idx);
+        for (const auto& path : route.paths) {
+            key.push_back(path.back() - 1);
+        }
+        std::sort(key.begin() + 1, key.end());
+        auto it = groups.find(key);
+        if (it != groups.end() && it->second.route.paths.empty()) {
+            it->second.route = route;
+        }
+    }
+
+    // Route every remaining group once, from the first of its nets.
+    std::vector<int> src_idxs;
+    for (const auto& entry : groups) {
+        if (entry.second.route.paths.empty()) {
+            src_idxs.push_back(entry.first.front());
+        }
+    }
+    std::sort(src_idxs.begin(), src_idxs.end());
+    src_idxs.erase(std::unique(src_idxs.begin(), src_idxs.end()), src_idxs.end());
+    precomputeParents(src_idxs);
+
+    size_t routed_groups = 0;
+    for (auto& entry : groups) {
+        RouteGroup& group = entry.second;
+        if (group.route.paths.empty()) {
+            group.route = routeNet(nets[group.net_ids.front() - 1]);
+            routed_groups++;
+        }
+        updateLoad(group.route, static_cast<int>(group.net_ids.size()));
+        for (int net_id : group.net_ids) {
+            group.route.net_id = net_id;
+            routes_[net_id] = group.route;
+        }
+    }
+    assignRatios();
+    return routed_groups;
+}
+
+void Router::updateLoad(const NetRoute& route, int delta) {
+    // Count each directed edge once per net, even if several of its paths share it.
+    std::vector<std::pair<int, int>>& edges = scratch_edges_;
+    edges.clear();
+    for (const auto& path : route.paths) {
+        for (size_t k = 0; k + 1 < path.size(); ++k) {
+            edges.push_back({path[k] - 1, path[k + 1] - 1});
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    for (const auto& e : edges) {
+        load_[e.first][e.second] += delta;
+        dirty_[e.first][e.second] = 1;
+    }
+}
+
+void Router::assignRatios() {
+    const auto& topo = design_.getTopology();
+
+    // Only hops on edges whose load changed need a new ratio.
+    for (auto& entry : routes_) {
+        NetRoute& route = entry.second;
+        for (size_t i = 0; i < route.paths.size(); ++i) {
+            const auto& path = route.paths[i];
+            for (size_t k = 0; k + 1 < path.size(); ++k) {
+                int u = path[k] - 1;
+                int v = path[k + 1] - 1;
+                if (!dirty_[u][v]) {
+                    continue;
+                }
+                int channels = std::max(topo[u][v], 1);
+                route.ratios[i][k] = std::max(1, (load_[u][v] + channels - 1) / channels);
+            }
+        }
+    }
+
+    for (auto& row : dirty_) {
+        std::fill(row.begin(), row.end(), 0);
+    }
+}
+
+double Router::maxDelay() const {
+    double max_delay = 0.0;
+    for (const auto& entry : routes_) {
+        for (const auto& ratios : entry.second.ratios) {
+            double delay = 0.0;
+            for (double r : ratios) {
+                delay += r;
+            }
+            max_delay = std::max(max_delay, delay);
+        }
+    }
+    return max_delay;
+}
+
+void Router::loadRoutes(const std::string& filename, size_t num_nets) {
+    RouteFile file = readRouteFile(filename, num_nets);
+    size_t num_fpgas = design_.getTopology().size();
+    auto fail = [&](int net_id, const std::string& message) {
+        throw std::runtime_error("Router Error: " + filename + ": net " + std::to_string(net_id) + ": " + message);
+    };
+
+    // Net IDs, FPGA IDs and hop counts index routes_, load_ and the ratios, so check them before use.
+    std::map<int, NetRoute> routes;   // Only replaces routes_ once the whole file is valid.
+    for (size_t e = 0; e < file.numEntries(); ++e) {
+        int net_id = file.net_ids[e];
+        if (net_id < 1 || (size_t)net_id > num_nets) {
+            fail(net_id, "ID is outside [1, " + std::to_string(num_nets) + "]");
+        }
+        // Route files list nets in ascending order, so append at the end.
+        NetRoute& route = routes.emplace_hint(routes.end(), net_id, NetRoute(net_id))->second;
+
+        for (size_t p = file.net_begin[e]; p < file.net_begin[e + 1]; ++p) {
+            auto path_begin = file.fpgas.begin() + file.path_begin[p];
+            auto path_end = file.fpgas.begin() + file.path_begin[p + 1];
+            auto ratio_begin = file.ratios.begin() + file.ratio_begin[p];
+            auto ratio_end = file.ratios.begin() + file.ratio_begin[p + 1];
+            size_t length = path_end - path_begin;
+            size_t num_ratios = ratio_end - ratio_begin;
+
+            for (auto it = path_begin; it != path_end; ++it) {
+                if (*it < 1 || (size_t)*it > num_fpgas) {
+                    fail(net_id, "F" + std::to_string(*it) + " is outside [1, " + std::to_string(num_fpgas) + "]");
+                }
+            }
+            if (length < 2) {
+                fail(net_id, "path needs at least 2 FPGAs");
+            }
+            if (num_ratios != length - 1) {
+                fail(net_id, "path has " + std::to_string(length) + " FPGAs but " + std::to_string(num_ratios) +
+                             " ratios");
+            }
+            route.paths.emplace_back(path_begin, path_end);
+            route.ratios.emplace_back(ratio_begin, ratio_end);
+        }
+    }
+
+    // Keep the loaded ratios until something changes.
+    routes_ = std::move(routes);
+    rebuildLoad();
+}
+
+void Router::setRoutes(std::map<int, NetRoute> routes) {
+    routes_ = std::move(routes);
+    rebuildLoad();
+}
+
+void Router::rebuildLoad() {
+    for (auto& row : load_) {
+        std::fill(row.begin(), row.end(), 0);
+    }
+    for (const auto& entry : routes_) {
+        updateLoad(entry.second, 1);
+    }
+    for (auto& row : dirty_) {
+        std::fill(row.begin(), row.end(), 0);
+    }
+}
+
+void Router::writeRoutes(const std::string& filename) const {
+    std::ofstream out_file(filename);
+    if (!out_file.is_open()) {
+        throw std::runtime_error("Router Error: Cannot open file for writing: " + filename);
+    }
+
+    for (const auto& entry : routes_) {
+        const NetRoute& route = entry.second;
+        out_file << "[net " << route.net_id << "]\n";
+        for (size_t i = 0; i < route.paths.size(); ++i) {
+            out_file << "[";
+            for (size_t k = 0; k < route.paths[i].size(); ++k) {
+                out_file << (k ? "," : "") << route.paths[i][k];
+            }
+            out_file << "] [";
+            for (size_t k = 0; k < route.ratios[i].size(); ++k) {
+                out_file << (k ? "," : "") << route.ratios[i][k];
+            }
+            out_file << "]\n";
+        }
+        out_file << "\n";
+    }
+}
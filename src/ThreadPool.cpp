@@ -0,0 +1,139 @@
+#include "ThreadPool.hpp"
+
+namespace {
+// Index of the pool worker running on this thread, or -1 for outside threads.
+thread_local int tls_worker_index = -1;
+}
+
+ThreadPool::ThreadPool(size_t num_threads) : pending_(0), next_queue_(0), stop_(false) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // The thread calling parallelFor() works too, so it counts as one of num_threads.
+    size_t num_workers = num_threads - 1;
+    for (size_t i = 0; i < num_workers; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < num_workers; ++i) {
+        threads_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Without workers (a single-thread pool) the caller runs the task itself.
+    if (queues_.empty()) {
+        task();
+        return;
+    }
+    // Workers push to their own deque to keep related tasks local.
+    size_t target = tls_worker_index >= 0 ? static_cast<size_t>(tls_worker_index)
+                                          : next_queue_++ % queues_.size();
+    // Count the task before it becomes visible so pending_ never drops below zero.
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        pending_++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    wake_cv_.notify_one();
+}
+
+bool ThreadPool::runPendingTask() {
+    std::function<void()> task;
+    size_t num_queues = queues_.size();
+    size_t self = tls_worker_index >= 0 ? static_cast<size_t>(tls_worker_index) : 0;
+
+    // Own queue first (LIFO), then steal the oldest task from the others.
+    for (size_t k = 0; k < num_queues && !task; ++k) {
+        WorkerQueue& queue = *queues_[(self + k) % num_queues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (k == 0 && tls_worker_index >= 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    pending_--;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    tls_worker_index = static_cast<int>(index);
+    while (true) {
+        if (runPendingTask()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait(lock, [this] { return stop_ || pending_ > 0; });
+        if (stop_ && pending_ == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t max_tasks, const std::function<void(size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    size_t num_tasks = std::min({std::max<size_t>(max_tasks, 1), count, concurrency()});
+
+    std::atomic<size_t> next_index(0);
+    std::atomic<size_t> running_helpers(num_tasks - 1);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    auto body = [&]() {
+        try {
+            for (size_t i = next_index++; i < count; i = next_index++) {
+                fn(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next_index = count; // Stop handing out further iterations.
+        }
+    };
+
+    for (size_t t = 1; t < num_tasks; ++t) {
+        submit([&]() {
+            body();
+            running_helpers--;
+        });
+    }
+    body();
+
+    // Help with other queued work until every helper of this loop has finished.
+    while (running_helpers > 0) {
+        if (!runPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
@@ -58,12 +58,25 @@ void printDesignStats(const Design& design) {
 /**
  * @brief 将net group信息输出到文件
  * @param design 包含设计数据的Design对象
+ * @param groups Design::consolidateNetGroups() 的结果，其内层即原始分组
  * @param output_file 输出文件路径
  */
-void outputNetGroupsToFile(const Design& design, const std::string& output_file) {
+void outputNetGroupsToFile(const Design& design, const Design::ConsolidatedGroupMap& groups,
+                           const std::string& output_file) {
     try {
-        // 获取net group信息
-        auto net_groups = design.groupNetsByFpgaConnection();
+        // 合并分组的内层就是原始分组；按连接模式排序，与 groupNetsByFpgaConnection() 的顺序一致
+        std::vector<std::pair<const std::string*, const std::vector<int>*>> sorted_groups;
+        for (const auto& entry : groups) {
+            for (const auto& group : entry.second) {
+                sorted_groups.push_back({&group.first, &group.second});
+            }
+        }
+        std::sort(sorted_groups.begin(), sorted_groups.end(),
+                  [](const auto& a, const auto& b) { return *a.first < *b.first; });
+        std::vector<const std::vector<int>*> net_groups;
+        for (const auto& entry : sorted_groups) {
+            net_groups.push_back(entry.second);
+        }
         
         // 打开输出文件
         std::ofstream out_file(output_file);
@@ -77,65 +90,60 @@ void outputNetGroupsToFile(const Design& design, const std::string& output_file)
         out_file << "# Format: Group [group_number]: Source_FPGA -> Sink_FPGA1(count),Sink_FPGA2(count) -> [net_id1, net_id2, ...]\n\n";
         
         // 写入每个net group的信息
+        const auto& nets = design.getNets();
         for (size_t i = 0; i < net_groups.size(); ++i) {
-            const auto& group = net_groups[i];
-            
-            // 获取第一个net的连接模式作为代表
-            if (!group.empty()) {
-                int first_net_id = group[0];
-                const auto& nets = design.getNets();
-                
-                // 查找第一个net以获取连接模式
-                for (const auto& net : nets) {
-                    if (net.id == first_net_id) {
-                        // 获取源FPGA
-                        std::string src_fpga = "unknown";
-                        if (net.source && net.source->fpga) {
-                            src_fpga = "F" + std::to_string(net.source->fpga->id);
-                        }
-                        
-                        // 获取目标FPGA及其节点数量
-                        std::string sink_fpgas = "unknown";
-                        if (!net.sinks.empty()) {
-                            // 统计每个FPGA上的节点数量
-                            std::map<int, int> fpga_counts;
-                            for (const auto& sink : net.sinks) {
-                                if (sink && sink->fpga) {
-                                    // 跳过与源FPGA相同的节点
-                                    if (sink->fpga->id == net.source->fpga->id) {
-                                        continue;
-                                    }
-                                    fpga_counts[sink->fpga->id]++;
-                                }
-                            }
-                            
-                            // 构建输出字符串
-                            if (!fpga_counts.empty()) {
-                                sink_fpgas = "";
-                                for (const auto& pair : fpga_counts) {
-                                    if (!sink_fpgas.empty()) {
-                                        sink_fpgas += ",";
-                                    }
-                                    sink_fpgas += "F" + std::to_string(pair.first) + " (" + std::to_string(pair.second) + ")";
-                                }
-                            }
+            const auto& group = *net_groups[i];
+            if (group.empty()) {
+                continue;
+            }
+
+            // 获取第一个net的连接模式作为代表（net ID 即行号）
+            const Net& net = nets[group[0] - 1];
+
+            // 获取源FPGA
+            std::string src_fpga = "unknown";
+            if (net.source && net.source->fpga) {
+                src_fpga = "F" + std::to_string(net.source->fpga->id);
+            }
+
+            // 获取目标FPGA及其节点数量
+            std::string sink_fpgas = "unknown";
+            if (!net.sinks.empty()) {
+                // 统计每个FPGA上的节点数量
+                std::map<int, int> fpga_counts;
+                for (const auto& sink : net.sinks) {
+                    if (sink && sink->fpga) {
+                        // 跳过与源FPGA相同的节点
+                        if (sink->fpga->id == net.source->fpga->id) {
+                            continue;
                         }
-                        
-                        // 写入连接模式
-                        out_file << "Group [" << i + 1 << "]: " << src_fpga << " -> " << sink_fpgas << " -> [";
-                        
-                        // 写入net ID列表
-                        for (size_t j = 0; j < group.size(); ++j) {
-                            out_file << "net" << group[j];
-                            if (j < group.size() - 1) {
-                                out_file << ", ";
-                            }
+                        fpga_counts[sink->fpga->id]++;
+                    }
+                }
+
+                // 构建输出字符串
+                if (!fpga_counts.empty()) {
+                    sink_fpgas = "";
+                    for (const auto& pair : fpga_counts) {
+                        if (!sink_fpgas.empty()) {
+                            sink_fpgas += ",";
                         }
-                        out_file << "]\n";
-                        break;
+                        sink_fpgas += "F" + std::to_string(pair.first) + " (" + std::to_string(pair.second) + ")";
                     }
                 }
             }
+
+            // 写入连接模式
+            out_file << "Group [" << i + 1 << "]: " << src_fpga << " -> " << sink_fpgas << " -> [";
+
+            // 写入net ID列表
+            for (size_t j = 0; j < group.size(); ++j) {
+                out_file << "net" << group[j];
+                if (j < group.size() - 1) {
+                    out_file << ", ";
+                }
+            }
+            out_file << "]\n";
         }
         
         // 写入统计信息
@@ -144,8 +152,8 @@ void outputNetGroupsToFile(const Design& design, const std::string& output_file)
         out_file << "# Total nets: ";
         
         int total_nets = 0;
-        for (const auto& group : net_groups) {
-            total_nets += group.size();
+        for (const auto* group : net_groups) {
+            total_nets += group->size();
         }
         out_file << total_nets << "\n";
         
@@ -157,4 +165,109 @@ void outputNetGroupsToFile(const Design& design, const std::string& output_file)
     } catch (const std::exception& e) {
         std::cerr << "Error writing net groups to file: " << e.what() << std::endl;
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 将合并后的net group信息输出到文件（忽略每个FPGA上的节点数量）
+ * @param consolidated Design::consolidateNetGroups() 的结果
+ * @param output_file 输出文件路径
+ */
+void outputConsolidatedNetGroupsToFile(const Design::ConsolidatedGroupMap& consolidated,
+                                       const std::string& output_file) {
+    try {
+
+        std::ofstream out_file(output_file);
+        if (!out_file.is_open()) {
+            std::cerr << "Error: Could not open output file: " << output_file << std::endl;
+            return;
+        }
+
+        // 写入文件头
+        out_file << "# Consolidated Net Groups by FPGA Connection Pattern\n";
+        out_file << "# Format: Consolidated_Group: Source_FPGA -> Sink_FPGA1,Sink_FPGA2 -> [net_id1, net_id2, ...]\n\n";
+
+        size_t group_counter = 1;
+        size_t total_original_groups = 0;
+        size_t total_nets = 0;
+        for (const auto& entry : consolidated) {
+            // 键的格式为 "src:sink1,sink2"
+            const std::string& key = entry.first;
+            size_t colon = key.find(':');
+
+            std::string sink_fpgas = "unknown";
+            if (colon + 1 < key.size()) {
+                sink_fpgas = "F";
+                for (size_t i = colon + 1; i < key.size(); ++i) {
+                    sink_fpgas += key[i];
+                    if (key[i] == ',') {
+                        sink_fpgas += "F";
+                    }
+                }
+            }
+
+            out_file << "Consolidated_Group [" << group_counter++ << "]: F" << key.substr(0, colon)
+                     << " -> " << sink_fpgas << " -> [";
+
+            // 按原始分组顺序写入所有net ID
+            bool first = true;
+            for (const auto& group : entry.second) {
+                for (int net_id : group.second) {
+                    out_file << (first ? "" : ", ") << "net" << net_id;
+                    first = false;
+                }
+                total_nets += group.second.size();
+            }
+            out_file << "]\n";
+            total_original_groups += entry.second.size();
+        }
+
+        // 写入统计信息
+        out_file << "\n# Statistics:\n";
+        out_file << "# Original groups: " << total_original_groups << "\n";
+        out_file << "# Consolidated groups: " << consolidated.size() << "\n";
+        out_file << "# Total nets: " << total_nets << "\n";
+
+        out_file.close();
+
+        std::cout << "Consolidated net groups information has been written to: " << output_file << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error writing consolidated net groups to file: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 创建并返回一个算例的输出目录 output/<算例名>/
+ * @param case_dir 输入算例目录
+ * @return 以 '/' 结尾的输出目录路径
+ */
+std::string prepareOutputDir(const std::string& case_dir) {
+    // 去掉末尾的 '/'，取算例目录名
+    std::filesystem::path case_path = std::filesystem::absolute(case_dir).lexically_normal();
+    if (case_path.filename().empty()) {
+        case_path = case_path.parent_path();
+    }
+    std::filesystem::path output_dir = std::filesystem::path("output") / case_path.filename();
+    std::filesystem::create_directories(output_dir);
+    return output_dir.string() + "/";
+}
+
+/**
+ * @brief 打印验证结果（是否合法、max delay以及前若干条错误信息）
+ * @param report Validator::validate() 的返回结果
+ */
+void printValidationReport(const ValidationReport& report) {
+    if (report.legal) {
+        std::cout << "Validation passed: " << report.routed_nets << " routed nets, max delay = "
+                  << report.max_delay << std::endl;
+        return;
+    }
+
+    std::cerr << "Validation failed with " << report.violations << " violation(s):" << std::endl;
+    for (const auto& error : report.errors) {
+        std::cerr << "  " << error << std::endl;
+    }
+    if (report.violations > report.errors.size()) {
+        std::cerr << "  ... " << report.violations - report.errors.size() << " more" << std::endl;
+    }
+}
@@ -0,0 +1,227 @@
+#include "Validator.hpp"
+#include "RouteFile.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+// Per-chunk results, merged after the parallel pass.
+struct ChunkResult {
+    std::vector<std::pair<size_t, double>> edge_usage;   // (row-major directed edge, 1/ratio) per net and edge.
+    double max_delay = 0.0;
+    size_t violations = 0;
+    std::vector<std::string> errors;
+
+    void fail(const std::string& message) {
+        if (violations++ < Validator::kMaxReportedErrors) {
+            errors.push_back(message);
+        }
+    }
+};
+
+} // namespace
+
+Validator::Validator(const Design& design)
+    : design_(design), topology_(design.getTopology()), pool_(nullptr), max_tasks_(1) {
+    if (design_.getFpgas().empty() || design_.getNets().empty() || topology_.empty()) {
+        throw std::logic_error("Validator Error: Design must be loaded before validation.");
+    }
+}
+
+void Validator::setThreadPool(ThreadPool* pool, size_t max_tasks) {
+    pool_ = pool;
+    max_tasks_ = std::max<size_t>(max_tasks, 1);
+}
+
+void Validator::loadNewTopo(const std::string& filename) {
+    topology_ = Design::parseTopology(filename, design_.getFpgas().size());
+}
+
+ValidationReport Validator::validate(const std::string& route_file) const {
+    const auto& nets = design_.getNets();
+    RouteFile buffer = readRouteFile(route_file, nets.size());
+    const auto& fpgas = design_.getFpgas();
+    size_t num_fpgas = topology_.size();
+    size_t num_entries = buffer.numEntries();
+
+    ValidationReport report;
+    report.routed_nets = num_entries;
+
+    std::vector<char> routed(nets.size() + 1, 0);
+    for (int net_id : buffer.net_ids) {
+        if (net_id > 0 && (size_t)net_id <= nets.size()) {
+            routed[net_id] = 1;
+        }
+    }
+
+    size_t num_chunks = pool_ ? std::min(max_tasks_, std::max<size_t>(num_entries, 1)) : 1;
+    std::vector<ChunkResult> chunks(num_chunks);
+
+    auto check_chunk = [&](size_t c) {
+        ChunkResult& result = chunks[c];
+        std::vector<char> is_sink(num_fpgas, 0);
+        std::vector<char> reached(num_fpgas, 0);
+        std::vector<std::pair<size_t, double>> net_edges;   // (edge, ratio) of every hop of the current net.
+
+        size_t begin = num_entries * c / num_chunks;
+        size_t end = num_entries * (c + 1) / num_chunks;
+        for (size_t e = begin; e < end; ++e) {
+            int net_id = buffer.net_ids[e];
+            // Message prefix, only built when a violation is reported.
+            auto tag = [net_id]() { return "net " + std::to_string(net_id) + ": "; };
+            if (net_id <= 0 || (size_t)net_id > nets.size()) {
+                result.fail(tag() + "does not exist.");
+                continue;
+            }
+            const Net& net = nets[net_id - 1];
+            int src = net.source && net.source->fpga ? net.source->fpga->id : -1;
+
+            std::vector<int> sink_fpgas;
+            for (const auto& sink : net.sinks) {
+                if (sink && sink->fpga && sink->fpga->id != src && !is_sink[sink->fpga->id - 1]) {
+                    is_sink[sink->fpga->id - 1] = 1;
+                    sink_fpgas.push_back(sink->fpga->id);
+                }
+            }
+
+            for (size_t p = buffer.net_begin[e]; p < buffer.net_begin[e + 1]; ++p) {
+                const int* path = &buffer.fpgas[buffer.path_begin[p]];
+                size_t length = buffer.path_begin[p + 1] - buffer.path_begin[p];
+                const double* ratios = &buffer.ratios[buffer.ratio_begin[p]];
+                size_t num_ratios = buffer.ratio_begin[p + 1] - buffer.ratio_begin[p];
+
+                if (length < 2 || num_ratios != length - 1) {
+                    result.fail(tag() + "path has " + std::to_string(length) + " FPGAs but " +
+                                std::to_string(num_ratios) + " ratios.");
+                    continue;
+                }
+                if (path[0] != src) {
+                    result.fail(tag() + "path starts at F" + std::to_string(path[0]) +
+                                " instead of source F" + std::to_string(src) + ".");
+                }
+
+                double delay = 0.0;
+                for (size_t k = 0; k + 1 < length; ++k) {
+                    int u = path[k] - 1;
+                    int v = path[k + 1] - 1;
+                    if (u < 0 || v < 0 || (size_t)u >= num_fpgas || (size_t)v >= num_fpgas || topology_[u][v] <= 0) {
+                        result.fail(tag() + "no physical link F" + std::to_string(path[k]) +
+                                    " -> F" + std::to_string(path[k + 1]) + ".");
+                        continue;
+                    }
+                    double ratio = ratios[k];
+                    // Written so that NaN fails the check too.
+                    if (!(ratio >= 1.0 && ratio <= kMaxTdmRatio)) {
+                        result.fail(tag() + "ratio " + std::to_string(ratio) + " on F" + std::to_string(path[k]) +
+                                    " -> F" + std::to_string(path[k + 1]) + " is outside [1, " +
+                                    std::to_string(static_cast<int>(kMaxTdmRatio)) + "].");
+                    }
+                    delay += ratio;
+                    net_edges.push_back({static_cast<size_t>(u) * num_fpgas + v, ratio});
+                }
+                result.max_delay = std::max(result.max_delay, delay);
+
+                int last = path[length - 1];
+                if (last < 1 || (size_t)last > num_fpgas || !is_sink[last - 1]) {
+                    result.fail(tag() + "path ends at F" + std::to_string(last) + ", which is not a sink FPGA.");
+                } else {
+                    reached[last - 1] = 1;
+                }
+            }
+
+            for (int fpga_id : sink_fpgas) {
+                if (!reached[fpga_id - 1]) {
+                    result.fail(tag() + "sink FPGA F" + std::to_string(fpga_id) + " is not reached.");
+                }
+                is_sink[fpga_id - 1] = 0;
+                reached[fpga_id - 1] = 0;
+            }
+
+            // A net occupies one time slot per edge, however many of its paths share it,
+            // and must use the same ratio on all of them.
+            std::sort(net_edges.begin(), net_edges.end());
+            for (size_t i = 0; i < net_edges.size();) {
+                size_t edge = net_edges[i].first;
+                size_t j = i + 1;
+                while (j < net_edges.size() && net_edges[j].first == edge) {
+                    ++j;
+                }
+                // Sorted by (edge, ratio), so a run with mixed ratios has different ends.
+                if (net_edges[j - 1].second != net_edges[i].second) {
+                    result.fail(tag() + "uses F" + std::to_string(edge / num_fpgas + 1) + " -> F" +
+                                std::to_string(edge % num_fpgas + 1) + " with different ratios.");
+                }
+                result.edge_usage.push_back({edge, 1.0 / net_edges[i].second});
+                i = j;
+            }
+            net_edges.clear();
+        }
+    };
+
+    if (pool_ && num_chunks > 1) {
+        pool_->parallelFor(num_chunks, num_chunks, check_chunk);
+    } else {
+        check_chunk(0);
+    }
+
+    // Merge chunk results into the only dense per-edge buffer.
+    std::vector<double> edge_usage(num_fpgas * num_fpgas, 0.0);
+    for (auto& chunk : chunks) {
+        report.max_delay = std::max(report.max_delay, chunk.max_delay);
+        report.violations += chunk.violations;
+        for (auto& error : chunk.errors) {
+            if (report.errors.size() < kMaxReportedErrors) {
+                report.errors.push_back(std::move(error));
+            }
+        }
+        for (const auto& usage : chunk.edge_usage) {
+            edge_usage[usage.first] += usage.second;
+        }
+    }
+
+    auto fail = [&](const std::string& message) {
+        if (report.violations++ < kMaxReportedErrors) {
+            report.errors.push_back(message);
+        }
+    };
+
+    // Channel capacity of every directed edge.
+    const double kEpsilon = 1e-9;
+    for (size_t u = 0; u < num_fpgas; ++u) {
+        for (size_t v = 0; v < num_fpgas; ++v) {
+            if (edge_usage[u * num_fpgas + v] > topology_[u][v] + kEpsilon) {
+                fail("edge F" + std::to_string(u + 1) + " -> F" + std::to_string(v + 1) + " needs " +
+                     std::to_string(edge_usage[u * num_fpgas + v]) + " channels but has " +
+                     std::to_string(topology_[u][v]) + ".");
+            }
+        }
+    }
+
+    // I/O limit of every FPGA.
+    for (size_t u = 0; u < num_fpgas; ++u) {
+        long long io = 0;
+        for (size_t v = 0; v < num_fpgas; ++v) {
+            io += topology_[u][v];
+        }
+        if (io > fpgas[u].max_io) {
+            fail("F" + std::to_string(u + 1) + " uses " + std::to_string(io) +
+                 " channels but max_io is " + std::to_string(fpgas[u].max_io) + ".");
+        }
+    }
+
+    // Nets that cross FPGAs must have a route.
+    for (const auto& net : nets) {
+        if (routed[net.id] || !net.source || !net.source->fpga) {
+            continue;
+        }
+        for (const auto& sink : net.sinks) {
+            if (sink && sink->fpga && sink->fpga != net.source->fpga) {
+                fail("net " + std::to_string(net.id) + ": crosses FPGAs but has no route.");
+                break;
+            }
+        }
+    }
+
+    report.legal = report.violations == 0;
+    return report;
+}
@@ -0,0 +1,256 @@
+#include "VizExport.hpp"
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// Stop coarsening once a level has at most this many clusters.
+const size_t kMinClusters = 16;
+
+// One level of detail, stored column by column as in the file.
+struct VizLevel {
+    std::vector<uint32_t> cluster_of_fpga;
+    std::vector<float> x, y;
+    std::vector<int32_t> fpga_count, node_count, max_io, used_io;
+    std::vector<uint32_t> edge_a, edge_b;
+    std::vector<int32_t> capacity, demand, load_ab, load_ba;
+
+    size_t numClusters() const { return x.size(); }
+};
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+const bool kBigEndianHost = true;
+#else
+const bool kBigEndianHost = false;
+#endif
+
+// The file is little-endian; all columns hold 4-byte values.
+template <class T>
+void writeColumn(std::ofstream& out, const std::vector<T>& column) {
+    static_assert(sizeof(T) == 4, "fviz columns are 32-bit");
+    if (column.empty()) {
+        return;
+    }
+    if (!kBigEndianHost) {
+        out.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+        return;
+    }
+    std::vector<char> bytes(column.size() * sizeof(T));
+    std::memcpy(bytes.data(), column.data(), bytes.size());
+    for (size_t i = 0; i < bytes.size(); i += 4) {
+        std::swap(bytes[i], bytes[i + 3]);
+        std::swap(bytes[i + 1], bytes[i + 2]);
+    }
+    out.write(bytes.data(), bytes.size());
+}
+
+void writeU32(std::ofstream& out, uint32_t value) {
+    writeColumn(out, std::vector<uint32_t>{value});
+}
+
+// Aggregates FPGA data into the clusters given by cluster_of_fpga.
+VizLevel buildLevel(const Design& design, const std::vector<std::vector<int>>& demand,
+                    const std::vector<std::vector<int>>* routed_load,
+                    const std::vector<std::pair<float, float>>& layout,
+                    const std::vector<uint32_t>& cluster_of_fpga, size_t num_clusters) {
+    const auto& fpgas = design.getFpgas();
+    const auto& topo = design.getTopology();
+    size_t num_fpgas = fpgas.size();
+
+    VizLevel level;
+    level.cluster_of_fpga = cluster_of_fpga;
+    level.x.assign(num_clusters, 0.0f);
+    level.y.assign(num_clusters, 0.0f);
+    level.fpga_count.assign(num_clusters, 0);
+    level.node_count.assign(num_clusters, 0);
+    level.max_io.assign(num_clusters, 0);
+    level.used_io.assign(num_clusters, 0);
+
+    for (size_t i = 0; i < num_fpgas; ++i) {
+        uint32_t c = cluster_of_fpga[i];
+        level.x[c] += layout[i].first;
+        level.y[c] += layout[i].second;
+        level.fpga_count[c]++;
+        level.node_count[c] += static_cast<int32_t>(fpgas[i].nodes.size());
+        level.max_io[c] += fpgas[i].max_io;
+        for (size_t j = 0; j < num_fpgas; ++j) {
+            level.used_io[c] += topo[i][j];
+        }
+    }
+    for (size_t c = 0; c < num_clusters; ++c) {
+        level.x[c] /= level.fpga_count[c];
+        level.y[c] /= level.fpga_count[c];
+    }
+
+    // Sum every FPGA pair into its cluster pair; keyed by a * num_clusters + b with a < b.
+    std::map<uint64_t, size_t> edge_index;
+    for (size_t i = 0; i < num_fpgas; ++i) {
+        for (size_t j = i + 1; j < num_fpgas; ++j) {
+            int load_ij = routed_load ? (*routed_load)[i][j] : 0;
+            int load_ji = routed_load ? (*routed_load)[j][i] : 0;
+            if (topo[i][j] == 0 && demand[i][j] == 0 && load_ij == 0 && load_ji == 0) {
+                continue;
+            }
+            uint32_t a = cluster_of_fpga[i];
+            uint32_t b = cluster_of_fpga[j];
+            if (a == b) {
+                continue;
+            }
+            if (a > b) {
+                std::swap(a, b);
+                std::swap(load_ij, load_ji);
+            }
+
+            uint64_t key = static_cast<uint64_t>(a) * num_clusters + b;
+            auto it = edge_index.find(key);
+            if (it == edge_index.end()) {
+                it = edge_index.emplace(key, level.edge_a.size()).first;
+                level.edge_a.push_back(a);
+                level.edge_b.push_back(b);
+                level.capacity.push_back(0);
+                level.demand.push_back(0);
+                level.load_ab.push_back(0);
+                level.load_ba.push_back(0);
+            }
+            size_t e = it->second;
+            level.capacity[e] += topo[i][j];
+            level.demand[e] += demand[i][j];
+            level.load_ab[e] += load_ij;
+            level.load_ba[e] += load_ji;
+        }
+    }
+    return level;
+}
+
+} // namespace
+
+std::vector<std::pair<float, float>> computeForceLayout(const std::vector<std::vector<int>>& topology,
+                                                        ThreadPool* pool, size_t max_tasks) {
+    size_t n = topology.size();
+    std::vector<std::pair<float, float>> layout(n, {0.5f, 0.5f});
+    if (n <= 1) {
+        return layout;
+    }
+
+    // Start on a circle so the result does not depend on random seeds.
+    const double kPi = 3.14159265358979323846;
+    std::vector<double> x(n), y(n), dx(n), dy(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = 0.5 + 0.5 * std::cos(2.0 * kPi * i / n);
+        y[i] = 0.5 + 0.5 * std::sin(2.0 * kPi * i / n);
+    }
+
+    const double k = 1.0 / std::sqrt(static_cast<double>(n));   // Ideal edge length in a unit square.
+    const int iterations = n <= 256 ? 300 : 100;
+    double temperature = 0.1;
+    const double cooling = temperature / iterations;
+
+    // Each FPGA only writes its own displacement, so the force loop runs in parallel.
+    auto forces = [&](size_t i) {
+        double fx = 0.0;
+        double fy = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            if (j == i) continue;
+            double ddx = x[i] - x[j];
+            double ddy = y[i] - y[j];
+            double dist = std::max(std::sqrt(ddx * ddx + ddy * ddy), 1e-6);
+            double push = k * k / dist;
+            int channels = topology[i][j] + topology[j][i];
+            double pull = channels > 0 ? std::sqrt(static_cast<double>(channels)) * dist * dist / k : 0.0;
+            fx += (ddx / dist) * (push - pull);
+            fy += (ddy / dist) * (push - pull);
+        }
+        dx[i] = fx;
+        dy[i] = fy;
+    };
+
+    for (int it = 0; it < iterations; ++it) {
+        if (pool) {
+            pool->parallelFor(n, max_tasks, forces);
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                forces(i);
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            double len = std::max(std::sqrt(dx[i] * dx[i] + dy[i] * dy[i]), 1e-9);
+            double step = std::min(len, temperature);
+            x[i] += dx[i] / len * step;
+            y[i] += dy[i] / len * step;
+        }
+        temperature -= cooling;
+    }
+
+    // Normalize into [0, 1] while keeping the aspect ratio.
+    double min_x = *std::min_element(x.begin(), x.end());
+    double min_y = *std::min_element(y.begin(), y.end());
+    double span = std::max(*std::max_element(x.begin(), x.end()) - min_x,
+                           *std::max_element(y.begin(), y.end()) - min_y);
+    span = std::max(span, 1e-9);
+    for (size_t i = 0; i < n; ++i) {
+        layout[i] = {static_cast<float>((x[i] - min_x) / span), static_cast<float>((y[i] - min_y) / span)};
+    }
+    return layout;
+}
+
+void exportVisualizationBinary(const Design& design, const std::vector<std::vector<int>>* routed_load,
+                               const std::string& filename, ThreadPool* pool, size_t max_tasks) {
+    if (design.getFpgas().empty() || design.getTopology().empty()) {
+        throw std::logic_error("Visualization Error: Not all data has been loaded.");
+    }
+
+    size_t num_fpgas = design.getFpgas().size();
+    std::vector<std::vector<int>> demand = design.computeLogicalDemand();
+    std::vector<std::pair<float, float>> layout = computeForceLayout(design.getTopology(), pool, max_tasks);
+
+    // Level 0: one cluster per FPGA.
+    std::vector<VizLevel> levels;
+    std::vector<uint32_t> cluster_of_fpga(num_fpgas);
+    for (size_t i = 0; i < num_fpgas; ++i) {
+        cluster_of_fpga[i] = static_cast<uint32_t>(i);
+    }
+    levels.push_back(buildLevel(design, demand, routed_load, layout, cluster_of_fpga, num_fpgas));
+
+    // Coarser levels: merge FPGAs that fall into the same cell of a grid that halves each time.
+    size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(num_fpgas))));
+    while (levels.back().numClusters() > kMinClusters && side > 1) {
+        side = (side + 1) / 2;
+        std::map<size_t, uint32_t> cell_to_cluster;
+        for (size_t i = 0; i < num_fpgas; ++i) {
+            size_t cx = std::min(static_cast<size_t>(layout[i].first * side), side - 1);
+            size_t cy = std::min(static_cast<size_t>(layout[i].second * side), side - 1);
+            auto it = cell_to_cluster.emplace(cy * side + cx, static_cast<uint32_t>(cell_to_cluster.size())).first;
+            cluster_of_fpga[i] = it->second;
+        }
+        if (cell_to_cluster.size() >= levels.back().numClusters()) {
+            continue; // This grid does not merge anything yet; try a coarser one.
+        }
+        levels.push_back(buildLevel(design, demand, routed_load, layout, cluster_of_fpga, cell_to_cluster.size()));
+    }
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("Visualization Error: Cannot open file for writing: " + filename);
+    }
+
+    out.write("FPGAVIZ1", 8);
+    writeU32(out, static_cast<uint32_t>(num_fpgas));
+    writeU32(out, static_cast<uint32_t>(levels.size()));
+    for (const auto& level : levels) {
+        writeU32(out, static_cast<uint32_t>(level.numClusters()));
+        writeU32(out, static_cast<uint32_t>(level.edge_a.size()));
+        writeColumn(out, level.cluster_of_fpga);
+        writeColumn(out, level.x);
+        writeColumn(out, level.y);
+        writeColumn(out, level.fpga_count);
+        writeColumn(out, level.node_count);
+        writeColumn(out, level.max_io);
+        writeColumn(out, level.used_io);
+        writeColumn(out, level.edge_a);
+        writeColumn(out, level.edge_b);
+        writeColumn(out, level.capacity);
+        writeColumn(out, level.demand);
+        writeColumn(out, level.load_ab);
+        writeColumn(out, level.load_ba);
+    }
+}
@@ -1,52 +1,123 @@
+#include "Batch.hpp"
 #include "Design.hpp"
+#include "Pipeline.hpp"
+#include "Router.hpp"
 #include "Utils.hpp"
 
+// Returns eco_dir/name if the ECO directory provides that file, otherwise base_dir/name.
+static std::string ecoFile(const std::string& base_dir, const std::string& eco_dir, const std::string& name) {
+    return std::filesystem::exists(eco_dir + name) ? eco_dir + name : base_dir + name;
+}
 
+/**
+ * @brief ECO mode: reroutes only the nets changed by a new .net/.fpga.out.
+ *
+ * The base directory holds the previous design and base_routes its routes
+ * (e.g. output/<base name>/design.route.out from an earlier run). The ECO
+ * directory holds the changed design.net and/or design.fpga.out. The updated
+ * routes are written to output/<eco name>/design.route.out.
+ */
+static int runEco(const std::string& base_dir, const std::string& eco_dir, const std::string& base_routes) {
+    Design previous;
+    loadDesign(previous, base_dir + "design.info", base_dir + "design.fpga.out",
+               base_dir + "design.net", base_dir + "design.topo");
+
+    Design design;
+    loadDesign(design, base_dir + "design.info", ecoFile(base_dir, eco_dir, "design.fpga.out"),
+               ecoFile(base_dir, eco_dir, "design.net"), base_dir + "design.topo");
+
+    // Loading the previous routes counts as file loading, like the design files.
+    Router router(design);
+    std::cout << "Loading " << base_routes << "..." << std::endl;
+    auto load_start = std::chrono::high_resolution_clock::now();
+    router.loadRoutes(base_routes, previous.getNets().size());
+    auto load_end = std::chrono::high_resolution_clock::now();
+    auto load_duration = std::chrono::duration_cast<std::chrono::milliseconds>(load_end - load_start);
+    std::cout << "Route loading time: " << load_duration.count() << " milliseconds" << std::endl;
+
+    auto eco_start = std::chrono::high_resolution_clock::now();
+    Design::NetDiff diff = design.diffNets(previous);
+    size_t new_routes = router.reroute(diff);
+    auto eco_end = std::chrono::high_resolution_clock::now();
+    auto eco_duration = std::chrono::duration_cast<std::chrono::milliseconds>(eco_end - eco_start);
+
+    std::cout << "\nECO: " << diff.changed.size() << " of " << design.getNets().size()
+              << " nets changed, " << new_routes << " new routes." << std::endl;
+    std::cout << "ECO routing time: " << eco_duration.count() << " milliseconds" << std::endl;
+    std::cout << "Max delay: " << router.maxDelay() << std::endl;
+
+    const std::string route_file = prepareOutputDir(eco_dir) + "design.route.out";
+    router.writeRoutes(route_file);
+    ThreadPool pool;
+    return validateRoutes(design, route_file, &pool, pool.concurrency()).legal ? 0 : 1;
+}
 
-int main() {
+/**
+ * @brief Check mode: validates an existing solution, like the checker in benchmarks/README.md.
+ *
+ * The router never re-networks, so design.newtopo is only used here, for solutions
+ * produced elsewhere: if the case directory has one, the routes are checked against it.
+ */
+static int runCheck(const std::string& case_dir, const std::string& route_file) {
+    Design design;
+    loadDesign(design, case_dir + "design.info", case_dir + "design.fpga.out",
+               case_dir + "design.net", case_dir + "design.topo");
+
+    std::string new_topo_file = case_dir + "design.newtopo";
+    if (!std::filesystem::exists(new_topo_file)) {
+        new_topo_file.clear();
+    }
+    ThreadPool pool;
+    return validateRoutes(design, route_file, &pool, pool.concurrency(), new_topo_file).legal ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
     auto start_time = std::chrono::high_resolution_clock::now();
 
     // UPDATED: File paths are now relative to the project root.
-    const std::string data_prefix = "benchmarks/case03/";
-    const std::string info_file = data_prefix + "design.info";
-    const std::string net_file = data_prefix + "design.net";
-    const std::string topo_file = data_prefix + "design.topo";
-    const std::string fpga_map_file = data_prefix + "design.fpga.out";
-
-    const std::string viz_output_file = "scripts/visualization_data.json";
+    std::string case_dir = "benchmarks/case03";
 
     try {
-        Design design;
-
-        // Load files in the correct logical order.
-        auto load_start = std::chrono::high_resolution_clock::now();
-
-        std::cout << "Loading " << info_file << "..." << std::endl;
-        design.loadInfo(info_file);
-
-        std::cout << "Loading " << fpga_map_file << "..." << std::endl;
-        design.loadFpgaMapping(fpga_map_file);
-
-        std::cout << "Loading " << net_file << "..." << std::endl;
-        design.loadNets(net_file);
-
-        std::cout << "Loading " << topo_file << "..." << std::endl;
-        design.loadTopo(topo_file);
-        auto load_end = std::chrono::high_resolution_clock::now();
-
-        std::cout << "\nAll files parsed successfully!\n" << std::endl;
-
-        // Print loading time
-        auto load_duration = std::chrono::duration_cast<std::chrono::milliseconds>(load_end - load_start);
-        std::cout << "File loading time: " << load_duration.count() << " milliseconds" << std::endl;
-        // Print a summary of the parsed data for verification.
-        // printDesignStats(design);
-
-        design.generateVisualizationData(viz_output_file);
-        
-        // 输出net group信息到文件
-        const std::string net_groups_file = "scripts/net_groups.txt";
-        outputNetGroupsToFile(design, net_groups_file);
+        // Usage: FRouter [case_dir] | FRouter --eco <base_case_dir> <eco_dir> [base_route_file]
+        //        FRouter --batch <case_dir>... | FRouter --check <case_dir> [route_file]
+        if (argc >= 2 && std::string(argv[1]) == "--batch") {
+            if (argc < 3) {
+                std::cerr << "Usage: " << argv[0] << " --batch <case_dir>..." << std::endl;
+                return 1;
+            }
+            return runBatch(std::vector<std::string>(argv + 2, argv + argc));
+        }
+        if (argc >= 2 && std::string(argv[1]) == "--check") {
+            if (argc < 3) {
+                std::cerr << "Usage: " << argv[0] << " --check <case_dir> [route_file]" << std::endl;
+                return 1;
+            }
+            std::string check_dir = std::string(argv[2]) + "/";
+            return runCheck(check_dir, argc >= 4 ? argv[3] : check_dir + "design.route.out");
+        }
+        if (argc >= 2 && std::string(argv[1]) == "--eco") {
+            if (argc < 4) {
+                std::cerr << "Usage: " << argv[0] << " --eco <base_case_dir> <eco_dir> [base_route_file]"
+                          << std::endl;
+                return 1;
+            }
+            std::string base_dir = std::string(argv[2]) + "/";
+            return runEco(base_dir, std::string(argv[3]) + "/", argc >= 5 ? argv[4] : base_dir + "design.route.out");
+        }
+        if (argc >= 2) {
+            case_dir = argv[1];
+        }
+
+        // Same flow as one batch case, with progress and the full validation report.
+        ThreadPool pool;
+        CaseResult result;
+        result.case_dir = case_dir;
+        result.output_dir = prepareOutputDir(case_dir);
+        result.threads = pool.concurrency();
+        runCase(result, pool, true);
+        if (!result.error.empty()) {
+            return 1;
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "An error occurred: " << e.what() << std::endl;